@@ -0,0 +1,84 @@
+#include "bareiss.h"
+
+#include <numeric>
+#include "thread_pool.h"
+
+BareissResult bareissEliminate(std::vector<BigInteger>& a, size_t rows,
+                               size_t columns, bool reduced) {
+    BareissResult result{0, false, std::vector<size_t>(rows)};
+    std::vector<size_t>& order = result.order;
+    std::iota(order.begin(), order.end(), 0);
+    BigInteger previous = 1;
+    for (size_t c = 0; c < columns && result.rank < rows; ++c) {
+        size_t r = result.rank;
+        size_t pivot = r;
+        while (pivot < rows &&
+               a[order[pivot] * columns + c].sign() == BigInteger::ZERO) {
+            ++pivot;
+        }
+        if (pivot == rows) {
+            continue;
+        }
+        if (pivot != r) {
+            std::swap(order[pivot], order[r]);
+            result.negated = !result.negated;
+        }
+        const BigInteger* pivot_row = a.data() + order[r] * columns;
+        const BigInteger pivot_value = pivot_row[c];
+        // Rows with a zero factor are scaled by pivot / previous.
+        bool unchanged = pivot_value == previous;
+        auto update = [&a, &order, &pivot_value, &previous, pivot_row, r, c,
+                       columns, reduced, unchanged](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                if (i == r) {
+                    continue;
+                }
+                BigInteger* row = a.data() + order[i] * columns;
+                const BigInteger factor = row[c];
+                if (factor.sign() == BigInteger::ZERO && unchanged) {
+                    continue;
+                }
+                for (size_t j = reduced ? 0 : c + 1; j < columns; ++j) {
+                    if (j == c) {
+                        continue;
+                    }
+                    BigInteger& cell = row[j];
+                    cell *= pivot_value;
+                    if (factor.sign() != BigInteger::ZERO) {
+                        cell -= factor * pivot_row[j];
+                    }
+                    cell /= previous;
+                }
+                row[c] = 0;
+            }
+        };
+        size_t first = reduced ? 0 : r + 1;
+        parallelRows(first, rows, (rows - first) * columns, update);
+        previous = pivot_value;
+        ++result.rank;
+    }
+    return result;
+}
+
+std::vector<BigInteger> clearDenominators(const std::vector<Rational>& a,
+                                          size_t rows, size_t columns,
+                                          std::vector<BigInteger>& scales) {
+    scales.assign(rows, 1);
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < columns; ++j) {
+            const BigInteger& denominator = a[i * columns + j].denominator();
+            if (denominator != 1) {
+                scales[i] *= denominator / gcd(scales[i], denominator);
+            }
+        }
+    }
+    std::vector<BigInteger> integers(rows * columns);
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < columns; ++j) {
+            const Rational& value = a[i * columns + j];
+            integers[i * columns + j] =
+                value.numerator() * (scales[i] / value.denominator());
+        }
+    }
+    return integers;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+#include "biginteger.h"
+
+// Row i of the eliminated matrix is row order[i] of the array.
+struct BareissResult {
+    size_t rank;
+    bool negated;
+    std::vector<size_t> order;
+};
+
+// Fraction-free elimination of a row-major rows x columns integer matrix:
+// every update is (pivot * a_ij - a_ic * a_rj) / previous_pivot, which is
+// exact, so entries stay bounded by minors of the input. With reduced the
+// entries above each pivot are cleared too (only for nonsingular input).
+// Rows are never moved; pivoting permutes the returned order instead.
+BareissResult bareissEliminate(std::vector<BigInteger>& a, size_t rows,
+                               size_t columns, bool reduced);
+
+// Scales each row of a Rational matrix to integers; scales[i] is the factor
+// applied to row i, the lcm of its denominators.
+std::vector<BigInteger> clearDenominators(const std::vector<Rational>& a,
+                                          size_t rows, size_t columns,
+                                          std::vector<BigInteger>& scales);
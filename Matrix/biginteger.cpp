@@ -1,5 +1,7 @@
 #include "biginteger.h"
 
+#include <bit>
+
 long long BigInteger::toNumber(sign_type sign) {
     if (sign == POSITIVE) {
         return 1;
@@ -122,6 +124,51 @@ bool BigInteger::unsignedOrder(const BigInteger& b) const {
     return false;
 }
 
+bool BigInteger::productBelow(const BigInteger& a, const BigInteger& b,
+                              const BigInteger& c, const BigInteger& d) {
+    size_t exponent_ab = a.digits_.size() + b.digits_.size();
+    size_t exponent_cd = c.digits_.size() + d.digits_.size();
+    long long lower_cd = c.digits_.back() * d.digits_.back();
+    if (lower_cd == 0 || exponent_cd < exponent_ab) {
+        return false;
+    }
+    if (exponent_cd >= exponent_ab + 2) {
+        return true;
+    }
+    long long upper_ab = (a.digits_.back() + 1) * (b.digits_.back() + 1);
+    if (exponent_cd == exponent_ab + 1) {
+        return lower_cd >= BASE_ || upper_ab <= lower_cd * BASE_;
+    }
+    return upper_ab <= lower_cd;
+}
+
+int BigInteger::compareProducts(const BigInteger& a, const BigInteger& b,
+                                const BigInteger& c, const BigInteger& d) {
+    long long sign_ab = toNumber(a.sign()) * toNumber(b.sign());
+    long long sign_cd = toNumber(c.sign()) * toNumber(d.sign());
+    if (sign_ab != sign_cd) {
+        return sign_ab < sign_cd ? -1 : 1;
+    }
+    if (sign_ab == 0) {
+        return 0;
+    }
+    int order = 0;
+    if (productBelow(a, b, c, d)) {
+        order = -1;
+    } else if (productBelow(c, d, a, b)) {
+        order = 1;
+    } else {
+        BigInteger ab = a * b;
+        BigInteger cd = c * d;
+        if (ab.unsignedOrder(cd)) {
+            order = -1;
+        } else if (cd.unsignedOrder(ab)) {
+            order = 1;
+        }
+    }
+    return static_cast<int>(sign_ab) * order;
+}
+
 BigInteger& BigInteger::operation(const BigInteger& b, bool type) {
     if (b.sign() == BigInteger::ZERO) {
         return *this;
@@ -339,20 +386,236 @@ BigInteger operator""_bi(const char* s, size_t size) {
     return {static_cast<std::string>(s)};
 }
 
-bool BigInteger::isEven() {
-    return digits_[0] % 2 == 0;
+long long BigInteger::remainder(long long modulus) const {
+    __int128 result = 0;
+    for (size_t i = digits_.size(); i > 0; --i) {
+        result = (result * BASE_ + digits_[i - 1]) % modulus;
+    }
+    if (sign() == NEGATIVE && result != 0) {
+        result = modulus - result;
+    }
+    return static_cast<long long>(result);
+}
+
+bool BigInteger::isEven() const {
+    return digits_.empty() || digits_[0] % 2 == 0;
+}
+
+void BigInteger::trim() {
+    while (digits_.size() > 1 && digits_.back() == 0) {
+        digits_.pop_back();
+    }
+    if (digits_.empty() || (digits_.size() == 1 && digits_[0] == 0)) {
+        digits_.assign(1, 0);
+        type_ = ZERO;
+    }
+}
+
+void BigInteger::multiplyLimbs(long long factor, long long addend) {
+    long long carry = addend;
+    for (long long& digit : digits_) {
+        long long cur = digit * factor + carry;
+        digit = cur % BASE_;
+        carry = cur / BASE_;
+    }
+    while (carry != 0) {
+        digits_.push_back(carry % BASE_);
+        carry /= BASE_;
+    }
 }
 
-void BigInteger::halve() {
+long long BigInteger::divideLimbs(long long divisor) {
     long long carry = 0;
     for (size_t i = digits_.size(); i > 0; --i) {
         long long cur = digits_[i - 1] + carry * BASE_;
-        digits_[i - 1] = cur / 2;
-        carry = cur % 2;
+        digits_[i - 1] = cur / divisor;
+        carry = cur % divisor;
     }
     while (digits_.size() > 1 && digits_.back() == 0) {
         digits_.pop_back();
     }
+    return carry;
+}
+
+std::vector<uint32_t> BigInteger::toWords(size_t count) const {
+    std::vector<uint32_t> words(count, 0);
+    BigInteger magnitude = *this;
+    for (size_t i = 0; i < count && magnitude.sign() != ZERO; ++i) {
+        words[i] = static_cast<uint32_t>(magnitude.divideLimbs(1LL << 32));
+        magnitude.trim();
+    }
+    if (sign() == NEGATIVE) {
+        uint32_t carry = 1;
+        for (uint32_t& word : words) {
+            word = ~word + carry;
+            carry = (carry != 0 && word == 0) ? 1 : 0;
+        }
+    }
+    return words;
+}
+
+BigInteger BigInteger::fromWords(std::vector<uint32_t> words) {
+    BigInteger result = 0;
+    bool negative = !words.empty() && (words.back() >> 31) != 0;
+    if (negative) {
+        uint32_t carry = 1;
+        for (uint32_t& word : words) {
+            word = ~word + carry;
+            carry = (carry != 0 && word == 0) ? 1 : 0;
+        }
+    }
+    result.type_ = negative ? NEGATIVE : POSITIVE;
+    for (size_t i = words.size(); i > 0; --i) {
+        result.multiplyLimbs(1LL << 32, words[i - 1]);
+    }
+    result.trim();
+    return result;
+}
+
+size_t BigInteger::bitLength() const {
+    if (sign() == ZERO) {
+        return 0;
+    }
+    size_t count = (digits_.size() * 30 + 31) / 32 + 1;
+    BigInteger magnitude = *this;
+    magnitude.type_ = POSITIVE;
+    std::vector<uint32_t> words = magnitude.toWords(count);
+    while (words.back() == 0) {
+        words.pop_back();
+    }
+    return 32 * (words.size() - 1) + std::bit_width(words.back());
+}
+
+size_t BigInteger::countTrailingZeros() const {
+    if (sign() == ZERO) {
+        return 0;
+    }
+    // BASE_ = 2^9 * 5^9, so the lowest limb gives the value modulo 2^9.
+    const long long limb_bits = 9;
+    if (digits_[0] % (1LL << limb_bits) != 0) {
+        return std::countr_zero(static_cast<uint64_t>(digits_[0]));
+    }
+    size_t count = 0;
+    BigInteger copy = *this;
+    while (copy.digits_[0] % (1LL << limb_bits) == 0) {
+        copy.divideLimbs(1LL << limb_bits);
+        count += limb_bits;
+    }
+    return count + std::countr_zero(static_cast<uint64_t>(copy.digits_[0]));
+}
+
+BigInteger& BigInteger::operator<<=(size_t shift) {
+    if (sign() == ZERO) {
+        return *this;
+    }
+    const size_t step = 29;
+    for (; shift >= step; shift -= step) {
+        multiplyLimbs(1LL << step, 0);
+    }
+    multiplyLimbs(1LL << shift, 0);
+    return *this;
+}
+
+BigInteger& BigInteger::operator>>=(size_t shift) {
+    if (sign() == ZERO) {
+        return *this;
+    }
+    const size_t step = 29;
+    bool lost = false;
+    for (; shift > 0 && digits_.back() != 0; shift -= std::min(shift, step)) {
+        lost = divideLimbs(1LL << std::min(shift, step)) != 0 || lost;
+    }
+    bool negative = sign() == NEGATIVE;
+    trim();
+    if (negative && lost) {
+        --*this;
+    }
+    return *this;
+}
+
+BigInteger& BigInteger::bitwise(const BigInteger& b, char operation) {
+    size_t count =
+        (std::max(digits_.size(), b.digits_.size()) * 30 + 31) / 32 + 1;
+    std::vector<uint32_t> words = toWords(count);
+    std::vector<uint32_t> other = b.toWords(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (operation == '&') {
+            words[i] &= other[i];
+        } else if (operation == '|') {
+            words[i] |= other[i];
+        } else {
+            words[i] ^= other[i];
+        }
+    }
+    return *this = fromWords(words);
+}
+
+BigInteger& BigInteger::operator&=(const BigInteger& b) {
+    return bitwise(b, '&');
+}
+
+BigInteger& BigInteger::operator|=(const BigInteger& b) {
+    return bitwise(b, '|');
+}
+
+BigInteger& BigInteger::operator^=(const BigInteger& b) {
+    return bitwise(b, '^');
+}
+
+BigInteger operator<<(const BigInteger& a, size_t shift) {
+    BigInteger copy = a;
+    copy <<= shift;
+    return copy;
+}
+
+BigInteger operator>>(const BigInteger& a, size_t shift) {
+    BigInteger copy = a;
+    copy >>= shift;
+    return copy;
+}
+
+BigInteger operator&(const BigInteger& a, const BigInteger& b) {
+    BigInteger copy = a;
+    copy &= b;
+    return copy;
+}
+
+BigInteger operator|(const BigInteger& a, const BigInteger& b) {
+    BigInteger copy = a;
+    copy |= b;
+    return copy;
+}
+
+BigInteger operator^(const BigInteger& a, const BigInteger& b) {
+    BigInteger copy = a;
+    copy ^= b;
+    return copy;
+}
+
+BigInteger gcd(const BigInteger& a, const BigInteger& b) {
+    BigInteger x = a < 0 ? -a : a;
+    BigInteger y = b < 0 ? -b : b;
+    if (!x) {
+        return y;
+    }
+    if (!y) {
+        return x;
+    }
+    size_t common_twos =
+        std::min(x.countTrailingZeros(), y.countTrailingZeros());
+    x >>= x.countTrailingZeros();
+    y >>= y.countTrailingZeros();
+    while (true) {
+        if (x > y) {
+            std::swap(x, y);
+        }
+        y -= x;
+        if (!y) {
+            break;
+        }
+        y >>= y.countTrailingZeros();
+    }
+    return x << common_twos;
 }
 
 Rational::Rational() : Rational(0){};
@@ -367,6 +630,14 @@ Rational Rational::operator-() const {
     return copy;
 }
 
+const BigInteger& Rational::numerator() const {
+    return numerator_;
+}
+
+const BigInteger& Rational::denominator() const {
+    return denominator_;
+}
+
 Rational& Rational::operator+=(const Rational& b) {
     numerator_ *= b.denominator_;
     numerator_ += (b.numerator_ * denominator_);
@@ -406,32 +677,11 @@ void Rational::make_rational() {
         denominator_.changeSign();
         numerator_.changeSign();
     }
-    while (numerator_.isEven() && denominator_.isEven()) {
-        numerator_.halve();
-        denominator_.halve();
-    }
-    BigInteger a = (numerator_ > 0 ? numerator_ : -numerator_);
-    BigInteger b = denominator_;
-    if (a > b) {
-        std::swap(a, b);
+    BigInteger common = gcd(numerator_, denominator_);
+    if (common != 1) {
+        numerator_ /= common;
+        denominator_ /= common;
     }
-    while (a) {
-        while (a.isEven()) {
-            a.halve();
-        }
-        while (b.isEven()) {
-            b.halve();
-        }
-        if (a > b) {
-            std::swap(a, b);
-        }
-        b -= a;
-        if (a > b) {
-            std::swap(a, b);
-        }
-    }
-    numerator_ /= b;
-    denominator_ /= b;
 }
 
 std::string Rational::toString() const {
@@ -497,7 +747,14 @@ Rational operator/(const Rational& a, const Rational& b) {
 }
 
 bool operator<(const Rational& r1, const Rational& r2) {
-    return r1.numerator_ * r2.denominator_ < r2.numerator_ * r1.denominator_;
+    if (r1.numerator_.sign() != r2.numerator_.sign()) {
+        return r1.numerator_ < r2.numerator_;
+    }
+    if (r1.denominator_ == r2.denominator_) {
+        return r1.numerator_ < r2.numerator_;
+    }
+    return BigInteger::compareProducts(r1.numerator_, r2.denominator_,
+                                       r2.numerator_, r1.denominator_) < 0;
 }
 
 bool operator>(const Rational& r1, const Rational& r2) {
@@ -505,7 +762,7 @@ bool operator>(const Rational& r1, const Rational& r2) {
 }
 
 bool operator==(const Rational& r1, const Rational& r2) {
-    return (r1 - r2).numerator_ == 0;
+    return r1.numerator_ == r2.numerator_ && r1.denominator_ == r2.denominator_;
 }
 
 bool operator!=(const Rational& r1, const Rational& r2) {
@@ -1,7 +1,11 @@
+#pragma once
+
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <vector>
+#include "limb_allocator.h"
 
 class BigInteger {
   public:
@@ -18,6 +22,11 @@ class BigInteger {
     BigInteger& operator*=(const BigInteger& b);
     BigInteger& operator/=(const BigInteger& b);
     BigInteger& operator%=(const BigInteger& b);
+    BigInteger& operator<<=(size_t shift);
+    BigInteger& operator>>=(size_t shift);
+    BigInteger& operator&=(const BigInteger& b);
+    BigInteger& operator|=(const BigInteger& b);
+    BigInteger& operator^=(const BigInteger& b);
     BigInteger operator-() const;
     BigInteger& operator++();
     BigInteger operator++(int);
@@ -25,19 +34,32 @@ class BigInteger {
     BigInteger operator--(int);
     friend bool operator<(const BigInteger& b1, const BigInteger& b2);
     friend bool operator==(const BigInteger& b1, const BigInteger& b2);
-    bool isEven();
-    void halve();
+    bool isEven() const;
+    size_t bitLength() const;
+    size_t countTrailingZeros() const;
+    long long remainder(long long modulus) const;
+    static int compareProducts(const BigInteger& a, const BigInteger& b,
+                               const BigInteger& c, const BigInteger& d);
 
   private:
+    friend class BigIntegerVector;
     BigInteger& operation(const BigInteger& b, bool type);
     BigInteger& unsignedSubtraction(const BigInteger& b);
     BigInteger& unsignedSum(const BigInteger& b);
     bool unsignedOrder(const BigInteger& b) const;
+    static bool productBelow(const BigInteger& a, const BigInteger& b,
+                             const BigInteger& c, const BigInteger& d);
     BigInteger& divMod(const BigInteger& b, bool divmod);
+    void multiplyLimbs(long long factor, long long addend);
+    long long divideLimbs(long long divisor);
+    void trim();
+    std::vector<uint32_t> toWords(size_t count) const;
+    static BigInteger fromWords(std::vector<uint32_t> words);
+    BigInteger& bitwise(const BigInteger& b, char operation);
     static long long toNumber(sign_type sign);
     static sign_type toSign(long long number);
     sign_type type_ = ZERO;
-    std::vector<long long> digits_;
+    std::vector<long long, LimbAllocator<long long>> digits_;
     static const long long BASE_ = 1000000000;
     static const long long BASE_LENGTH_ = 9;
 };
@@ -53,6 +75,13 @@ BigInteger operator-(const BigInteger& a, const BigInteger& b);
 BigInteger operator*(const BigInteger& a, const BigInteger& b);
 BigInteger operator/(const BigInteger& a, const BigInteger& b);
 BigInteger operator%(const BigInteger& a, const BigInteger& b);
+BigInteger operator<<(const BigInteger& a, size_t shift);
+BigInteger operator>>(const BigInteger& a, size_t shift);
+BigInteger operator&(const BigInteger& a, const BigInteger& b);
+BigInteger operator|(const BigInteger& a, const BigInteger& b);
+BigInteger operator^(const BigInteger& a, const BigInteger& b);
+// Greatest common divisor of |a| and |b|, by the binary algorithm.
+BigInteger gcd(const BigInteger& a, const BigInteger& b);
 std::istream& operator>>(std::istream& in, BigInteger& b);
 std::ostream& operator<<(std::ostream& out, const BigInteger& b);
 BigInteger operator""_bi(unsigned long long n);
@@ -73,6 +102,8 @@ class Rational {
     Rational& operator*=(const Rational& b);
     Rational& operator/=(const Rational& b);
     Rational operator-() const;
+    const BigInteger& numerator() const;
+    const BigInteger& denominator() const;
     std::string toString() const;
     std::string asDecimal(size_t precision = 0) const;
     explicit operator double() const;
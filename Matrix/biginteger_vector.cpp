@@ -0,0 +1,266 @@
+#include "biginteger_vector.h"
+
+#include <cassert>
+
+BigIntegerVector::BigIntegerVector(size_t size) : size_(size), data_(size) {}
+
+BigIntegerVector::BigIntegerVector(const std::vector<BigInteger>& values)
+    : BigIntegerVector(values.size()) {
+    for (size_t i = 0; i < values.size(); ++i) {
+        set(i, values[i]);
+    }
+}
+
+size_t BigIntegerVector::size() const {
+    return size_;
+}
+
+size_t BigIntegerVector::width() const {
+    return width_;
+}
+
+void BigIntegerVector::resizeLimbs(size_t width) {
+    if (width > width_) {
+        width_ = width;
+        data_.resize(width_ * size_, 0);
+    }
+}
+
+long long BigIntegerVector::floorDiv(long long limb) {
+    long long carry = limb / BigInteger::BASE_;
+    return limb % BigInteger::BASE_ < 0 ? carry - 1 : carry;
+}
+
+void BigIntegerVector::normalize() const {
+    if (spread_ == 1) {
+        return;
+    }
+    for (size_t l = 0; l + 1 < width_; ++l) {
+        long long* row = data_.data() + l * size_;
+        long long* next = row + size_;
+        for (size_t i = 0; i < size_; ++i) {
+            long long carry = floorDiv(row[i]);
+            row[i] -= carry * BigInteger::BASE_;
+            next[i] += carry;
+        }
+    }
+    bool overflow = true;
+    while (overflow) {
+        overflow = false;
+        const long long* top = data_.data() + (width_ - 1) * size_;
+        for (size_t i = 0; i < size_; ++i) {
+            overflow = overflow || top[i] >= BigInteger::BASE_ ||
+                       top[i] <= -BigInteger::BASE_;
+        }
+        if (!overflow) {
+            break;
+        }
+        data_.resize((width_ + 1) * size_, 0);
+        for (size_t i = 0; i < size_; ++i) {
+            long long& limb = data_[(width_ - 1) * size_ + i];
+            long long carry = floorDiv(limb);
+            limb -= carry * BigInteger::BASE_;
+            data_[width_ * size_ + i] = carry;
+        }
+        ++width_;
+    }
+    spread_ = 1;
+}
+
+BigInteger BigIntegerVector::fromLimbs(std::vector<long long>& limbs) {
+    for (size_t l = 0; l + 1 < limbs.size(); ++l) {
+        long long carry = floorDiv(limbs[l]);
+        limbs[l] -= carry * BigInteger::BASE_;
+        limbs[l + 1] += carry;
+    }
+    BigInteger result;
+    result.type_ = BigInteger::POSITIVE;
+    if (limbs.back() < 0) {
+        result.type_ = BigInteger::NEGATIVE;
+        for (long long& limb : limbs) {
+            limb = -limb;
+        }
+        for (size_t l = 0; l + 1 < limbs.size(); ++l) {
+            long long carry = floorDiv(limbs[l]);
+            limbs[l] -= carry * BigInteger::BASE_;
+            limbs[l + 1] += carry;
+        }
+    }
+    while (limbs.back() >= BigInteger::BASE_) {
+        long long carry = limbs.back() / BigInteger::BASE_;
+        limbs.back() %= BigInteger::BASE_;
+        limbs.push_back(carry);
+    }
+    while (limbs.size() > 1 && limbs.back() == 0) {
+        limbs.pop_back();
+    }
+    if (limbs.size() == 1 && limbs[0] == 0) {
+        result.type_ = BigInteger::ZERO;
+    }
+    result.digits_.assign(limbs.begin(), limbs.end());
+    return result;
+}
+
+BigInteger BigIntegerVector::get(size_t index) const {
+    normalize();
+    std::vector<long long> limbs(width_);
+    for (size_t l = 0; l < width_; ++l) {
+        limbs[l] = data_[l * size_ + index];
+    }
+    return fromLimbs(limbs);
+}
+
+void BigIntegerVector::set(size_t index, const BigInteger& value) {
+    normalize();
+    resizeLimbs(value.digits_.size() + 1);
+    long long sign = BigInteger::toNumber(value.sign());
+    for (size_t l = 0; l < width_; ++l) {
+        data_[l * size_ + index] =
+            l < value.digits_.size() ? sign * value.digits_[l] : 0;
+    }
+    // Negative values are carried like normalize() does, so that only the
+    // top limb carries the sign; the spare top limb absorbs the last carry.
+    for (size_t l = 0; l + 1 < width_; ++l) {
+        long long& limb = data_[l * size_ + index];
+        long long carry = floorDiv(limb);
+        limb -= carry * BigInteger::BASE_;
+        data_[(l + 1) * size_ + index] += carry;
+    }
+}
+
+BigIntegerVector& BigIntegerVector::sumSub(bool plus,
+                                           const BigIntegerVector& other) {
+    assert(size_ == other.size_);
+    if (spread_ + other.spread_ > MAX_SPREAD_) {
+        normalize();
+        other.normalize();
+    }
+    resizeLimbs(other.width_);
+    long long* dst = data_.data();
+    const long long* src = other.data_.data();
+    size_t count = other.width_ * size_;
+    if (plus) {
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] += src[i];
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] -= src[i];
+        }
+    }
+    spread_ += other.spread_;
+    return *this;
+}
+
+BigIntegerVector& BigIntegerVector::operator+=(const BigIntegerVector& other) {
+    return sumSub(true, other);
+}
+
+BigIntegerVector& BigIntegerVector::operator-=(const BigIntegerVector& other) {
+    return sumSub(false, other);
+}
+
+BigIntegerVector& BigIntegerVector::operator*=(long long scalar) {
+    normalize();
+    unsigned long long magnitude =
+        scalar < 0 ? 0ULL - static_cast<unsigned long long>(scalar)
+                   : static_cast<unsigned long long>(scalar);
+    std::vector<long long> factors;
+    while (magnitude != 0) {
+        factors.push_back(
+            static_cast<long long>(magnitude % BigInteger::BASE_));
+        magnitude /= BigInteger::BASE_;
+    }
+    std::vector<long long> product((width_ + factors.size()) * size_, 0);
+    size_t count = width_ * size_;
+    for (size_t k = 0; k < factors.size(); ++k) {
+        long long factor = scalar < 0 ? -factors[k] : factors[k];
+        long long* dst = product.data() + k * size_;
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] += data_[i] * factor;
+        }
+    }
+    width_ += factors.size();
+    if (factors.empty()) {
+        product.assign(size_, 0);
+        width_ = 1;
+    }
+    data_ = std::move(product);
+    spread_ = MAX_SPREAD_;
+    normalize();
+    return *this;
+}
+
+long long BigIntegerVector::limbAt(size_t limb, size_t index,
+                                   size_t width) const {
+    if (limb + 1 < width_) {
+        return data_[limb * size_ + index];
+    }
+    long long top = data_[(width_ - 1) * size_ + index];
+    if (limb + 1 == width) {
+        if (limb + 1 == width_) {
+            return top;
+        }
+        return top < 0 ? -1 : 0;
+    }
+    if (limb + 1 == width_) {
+        return top < 0 ? top + BigInteger::BASE_ : top;
+    }
+    return top < 0 ? BigInteger::BASE_ - 1 : 0;
+}
+
+std::vector<int> BigIntegerVector::compare(
+    const BigIntegerVector& other) const {
+    normalize();
+    other.normalize();
+    size_t width = std::max(width_, other.width_);
+    std::vector<int> result(size_, 0);
+    for (size_t l = width; l > 0; --l) {
+        for (size_t i = 0; i < size_; ++i) {
+            long long a = limbAt(l - 1, i, width);
+            long long b = other.limbAt(l - 1, i, width);
+            if (result[i] == 0) {
+                result[i] = static_cast<int>(a > b) - static_cast<int>(a < b);
+            }
+        }
+    }
+    return result;
+}
+
+BigInteger BigIntegerVector::sum() const {
+    normalize();
+    std::vector<long long> limbs(width_, 0);
+    for (size_t l = 0; l < width_; ++l) {
+        const long long* row = data_.data() + l * size_;
+        long long total = 0;
+        for (size_t i = 0; i < size_; ++i) {
+            total += row[i];
+        }
+        limbs[l] = total;
+    }
+    return fromLimbs(limbs);
+}
+
+BigIntegerVector operator+(const BigIntegerVector& a,
+                           const BigIntegerVector& b) {
+    BigIntegerVector copy = a;
+    copy += b;
+    return copy;
+}
+
+BigIntegerVector operator-(const BigIntegerVector& a,
+                           const BigIntegerVector& b) {
+    BigIntegerVector copy = a;
+    copy -= b;
+    return copy;
+}
+
+BigIntegerVector operator*(const BigIntegerVector& a, long long scalar) {
+    BigIntegerVector copy = a;
+    copy *= scalar;
+    return copy;
+}
+
+BigIntegerVector operator*(long long scalar, const BigIntegerVector& a) {
+    return a * scalar;
+}
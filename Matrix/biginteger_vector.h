@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include "biginteger.h"
+
+class BigIntegerVector {
+  public:
+    BigIntegerVector() = default;
+    explicit BigIntegerVector(size_t size);
+    BigIntegerVector(const std::vector<BigInteger>& values);
+    size_t size() const;
+    size_t width() const;
+    BigInteger get(size_t index) const;
+    void set(size_t index, const BigInteger& value);
+    BigIntegerVector& operator+=(const BigIntegerVector& other);
+    BigIntegerVector& operator-=(const BigIntegerVector& other);
+    BigIntegerVector& operator*=(long long scalar);
+    std::vector<int> compare(const BigIntegerVector& other) const;
+    BigInteger sum() const;
+
+  private:
+    BigIntegerVector& sumSub(bool plus, const BigIntegerVector& other);
+    void resizeLimbs(size_t width);
+    void normalize() const;
+    long long limbAt(size_t limb, size_t index, size_t width) const;
+    static long long floorDiv(long long limb);
+    static BigInteger fromLimbs(std::vector<long long>& limbs);
+    size_t size_ = 0;
+    // limb l of element i is stored at data_[l * size_ + i]; limbs are lazy
+    // (not carried) until normalize(), |limb| < spread_ * BASE.
+    mutable size_t width_ = 1;
+    mutable std::vector<long long> data_;
+    mutable long long spread_ = 1;
+    static const long long MAX_SPREAD_ = 1LL << 30;
+};
+
+BigIntegerVector operator+(const BigIntegerVector& a,
+                           const BigIntegerVector& b);
+BigIntegerVector operator-(const BigIntegerVector& a,
+                           const BigIntegerVector& b);
+BigIntegerVector operator*(const BigIntegerVector& a, long long scalar);
+BigIntegerVector operator*(long long scalar, const BigIntegerVector& a);
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cmath>
+#include <random>
+#include "polynomial.h"
+
+// Reduces the row-major n x n matrix h to upper Hessenberg form (zero below
+// the subdiagonal) by similarity transforms: each row operation is undone
+// by the inverse column operation, so the characteristic polynomial is
+// kept. Floating-point fields pivot on the largest subdiagonal entry.
+template <typename Field>
+void hessenbergReduce(std::vector<Field>& h, size_t n) {
+    StridedRows<Field> rows{h.data(), n};
+    for (size_t j = 0; j + 2 < n; ++j) {
+        size_t pivot = n;
+        for (size_t i = j + 1; i < n; ++i) {
+            if (rows[i][j] == Field(0)) {
+                continue;
+            }
+            if constexpr (!std::is_floating_point_v<Field>) {
+                pivot = i;
+                break;
+            } else if (pivot == n ||
+                       std::abs(rows[i][j]) > std::abs(rows[pivot][j])) {
+                pivot = i;
+            }
+        }
+        if (pivot == n) {
+            continue;
+        }
+        if (pivot != j + 1) {
+            std::swap_ranges(rows[pivot], rows[pivot] + n, rows[j + 1]);
+            for (size_t i = 0; i < n; ++i) {
+                std::swap(rows[i][pivot], rows[i][j + 1]);
+            }
+        }
+        Field pivot_inverse = inverse(rows[j + 1][j]);
+        for (size_t k = j + 2; k < n; ++k) {
+            if (rows[k][j] == Field(0)) {
+                continue;
+            }
+            Field factor = rows[k][j] * pivot_inverse;
+            subtractRow(rows, k, j + 1, factor, j, n);
+            for (size_t i = 0; i < n; ++i) {
+                rows[i][j + 1] += factor * rows[i][k];
+            }
+        }
+    }
+}
+
+template <size_t N, typename Field>
+SquareMatrix<N, Field> hessenberg(const SquareMatrix<N, Field>& a) {
+    std::vector<Field> h(N * N);
+    for (size_t i = 0; i < N; ++i) {
+        std::copy(a[i].begin(), a[i].end(), h.begin() + i * N);
+    }
+    hessenbergReduce(h, N);
+    SquareMatrix<N, Field> result;
+    for (size_t i = 0; i < N; ++i) {
+        std::copy(h.begin() + i * N, h.begin() + (i + 1) * N,
+                  result[i].begin());
+    }
+    return result;
+}
+
+// det(x I - a) in O(N^3): with h the Hessenberg form, the characteristic
+// polynomials p_k of its leading k x k blocks satisfy
+// p_k = (x - h[k-1][k-1]) p_(k-1)
+//       - sum_(i<k) h[i-1][k-1] h[i][i-1] ... h[k-1][k-2] p_(i-1).
+template <size_t N, typename Field>
+Polynomial<Field> charpoly(const SquareMatrix<N, Field>& a) {
+    std::vector<Field> h(N * N);
+    for (size_t i = 0; i < N; ++i) {
+        std::copy(a[i].begin(), a[i].end(), h.begin() + i * N);
+    }
+    hessenbergReduce(h, N);
+    StridedRows<Field> rows{h.data(), N};
+    std::vector<std::vector<Field>> minors(N + 1);
+    minors[0] = {Field(1)};
+    for (size_t k = 1; k <= N; ++k) {
+        std::vector<Field>& minor = minors[k];
+        minor.assign(k + 1, Field(0));
+        for (size_t d = 0; d < k; ++d) {
+            minor[d + 1] += minors[k - 1][d];
+            minor[d] -= rows[k - 1][k - 1] * minors[k - 1][d];
+        }
+        Field product(1);
+        for (size_t i = k - 1; i > 0; --i) {
+            product *= rows[i][i - 1];
+            if (product == Field(0)) {
+                break;
+            }
+            Field factor = rows[i - 1][k - 1] * product;
+            for (size_t d = 0; d < minors[i - 1].size(); ++d) {
+                minor[d] -= factor * minors[i - 1][d];
+            }
+        }
+    }
+    return Polynomial<Field>(minors[N]);
+}
+
+// The least monic f with f(a) v = 0. Krylov vectors a^k v are reduced
+// against the earlier ones, kept in echelon form together with the
+// polynomial that produces each from v, until one reduces to zero; that
+// polynomial is the answer. O(N^2 deg f).
+template <size_t N, typename Field>
+Polynomial<Field> vectorMinpoly(const SquareMatrix<N, Field>& a,
+                                std::vector<Field> v) {
+    std::vector<std::vector<Field>> basis;
+    std::vector<std::vector<Field>> polynomials;
+    std::vector<size_t> pivots;
+    std::vector<Field> pivot_inverses;
+    std::vector<Field> polynomial = {Field(1)};
+    while (true) {
+        for (size_t b = 0; b < basis.size(); ++b) {
+            if (v[pivots[b]] == Field(0)) {
+                continue;
+            }
+            Field factor = v[pivots[b]] * pivot_inverses[b];
+            for (size_t j = 0; j < N; ++j) {
+                v[j] -= factor * basis[b][j];
+            }
+            for (size_t d = 0; d < polynomials[b].size(); ++d) {
+                polynomial[d] -= factor * polynomials[b][d];
+            }
+        }
+        size_t pivot = 0;
+        while (pivot < N && v[pivot] == Field(0)) {
+            ++pivot;
+        }
+        if (pivot == N) {
+            return Polynomial<Field>(polynomial);
+        }
+        pivots.push_back(pivot);
+        pivot_inverses.push_back(inverse(v[pivot]));
+        std::vector<Field> next(N, Field(0));
+        for (size_t i = 0; i < N; ++i) {
+            for (size_t j = 0; j < N; ++j) {
+                next[i] += a[i][j] * v[j];
+            }
+        }
+        basis.push_back(std::move(v));
+        polynomials.push_back(polynomial);
+        polynomial.insert(polynomial.begin(), Field(0));
+        v = std::move(next);
+    }
+}
+
+// Minimal polynomial of a over an exact field, as the lcm of the minimal
+// polynomials of random vectors, each of which divides it. The lcm is
+// grown until a vector leaves it unchanged or it reaches degree N. Like
+// SparseMatrix this is Monte Carlo: the result always divides the true
+// one, and is too small only if two vectors in a row miss the same
+// factor, each with probability about N over the sample range.
+template <size_t N, typename Field>
+Polynomial<Field> minpoly(const SquareMatrix<N, Field>& a) {
+    std::mt19937_64 random(N);
+    std::uniform_int_distribution<int> distribution(-(1 << 15), 1 << 15);
+    Polynomial<Field> result{Field(1)};
+    while (result.degree() < static_cast<int>(N)) {
+        std::vector<Field> v(N);
+        for (Field& value : v) {
+            value = Field(distribution(random));
+        }
+        Polynomial<Field> next = lcm(result, vectorMinpoly(a, v));
+        if (next == result) {
+            break;
+        }
+        result = next;
+    }
+    return result;
+}
@@ -0,0 +1,124 @@
+#include "crt.h"
+
+#include "modular.h"
+
+CRT::CRT(const std::vector<long long>& moduli)
+    : moduli_(moduli), tree_(1), inverses_(moduli.size()) {
+    for (long long modulus : moduli_) {
+        tree_[0].emplace_back(modulus);
+    }
+    if (moduli_.empty()) {
+        tree_[0].emplace_back(1);
+    }
+    while (tree_.back().size() > 1) {
+        const std::vector<BigInteger>& level = tree_.back();
+        std::vector<BigInteger> next;
+        for (size_t i = 0; i + 1 < level.size(); i += 2) {
+            next.push_back(level[i] * level[i + 1]);
+        }
+        if (level.size() % 2 == 1) {
+            next.push_back(level.back());
+        }
+        tree_.push_back(std::move(next));
+    }
+    for (size_t i = 0; i < moduli_.size(); ++i) {
+        auto modulus = static_cast<uint64_t>(moduli_[i]);
+        uint64_t cofactor = 1 % modulus;
+        for (size_t j = 0; j < moduli_.size(); ++j) {
+            if (j != i) {
+                cofactor = mulMod(cofactor,
+                                  static_cast<uint64_t>(moduli_[j]) % modulus,
+                                  modulus);
+            }
+        }
+        inverses_[i] = static_cast<long long>(inverseMod(cofactor, modulus));
+    }
+}
+
+size_t CRT::size() const {
+    return moduli_.size();
+}
+
+const std::vector<long long>& CRT::moduli() const {
+    return moduli_;
+}
+
+const BigInteger& CRT::modulus() const {
+    return tree_.back()[0];
+}
+
+std::vector<long long> CRT::reduce(const BigInteger& value) const {
+    std::vector<BigInteger> current = {value % modulus()};
+    for (size_t level = tree_.size() - 1; level > 1; --level) {
+        std::vector<BigInteger> next;
+        for (size_t i = 0; i < tree_[level - 1].size(); ++i) {
+            next.push_back(current[i / 2] % tree_[level - 1][i]);
+        }
+        current = std::move(next);
+    }
+    std::vector<long long> residues(moduli_.size());
+    for (size_t i = 0; i < moduli_.size(); ++i) {
+        const BigInteger& parent = current[tree_.size() > 1 ? i / 2 : 0];
+        residues[i] = parent.remainder(moduli_[i]);
+    }
+    return residues;
+}
+
+BigInteger CRT::reconstruct(const std::vector<long long>& residues) const {
+    std::vector<BigInteger> current;
+    for (size_t i = 0; i < moduli_.size(); ++i) {
+        auto modulus = static_cast<uint64_t>(moduli_[i]);
+        auto residue = static_cast<uint64_t>(
+            (residues[i] % moduli_[i] + moduli_[i]) % moduli_[i]);
+        current.emplace_back(static_cast<long long>(
+            mulMod(residue, static_cast<uint64_t>(inverses_[i]), modulus)));
+    }
+    if (current.empty()) {
+        return 0;
+    }
+    for (size_t level = 0; level + 1 < tree_.size(); ++level) {
+        std::vector<BigInteger> next;
+        for (size_t i = 0; i + 1 < current.size(); i += 2) {
+            next.push_back(current[i] * tree_[level][i + 1] +
+                           current[i + 1] * tree_[level][i]);
+        }
+        if (current.size() % 2 == 1) {
+            next.push_back(current.back());
+        }
+        current = std::move(next);
+    }
+    return current[0] % modulus();
+}
+
+BigInteger CRT::reconstructSigned(
+    const std::vector<long long>& residues) const {
+    BigInteger result = reconstruct(residues);
+    if (result * 2 > modulus()) {
+        result -= modulus();
+    }
+    return result;
+}
+
+std::optional<Rational> CRT::rationalReconstruct(const BigInteger& value,
+                                                 const BigInteger& modulus) {
+    BigInteger old_r = modulus;
+    BigInteger r = value % modulus;
+    if (r < 0) {
+        r += modulus;
+    }
+    BigInteger old_s = 0;
+    BigInteger s = 1;
+    while (r * r * 2 >= modulus) {
+        BigInteger q = old_r / r;
+        BigInteger temp = old_r - q * r;
+        old_r = r;
+        r = temp;
+        temp = old_s - q * s;
+        old_s = s;
+        s = temp;
+    }
+    if (s == 0 || s * s * 2 >= modulus) {
+        return std::nullopt;
+    }
+    return Rational(r) / Rational(s);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+#include "biginteger.h"
+
+class CRT {
+  public:
+    explicit CRT(const std::vector<long long>& moduli);
+    size_t size() const;
+    const std::vector<long long>& moduli() const;
+    const BigInteger& modulus() const;
+    std::vector<long long> reduce(const BigInteger& value) const;
+    BigInteger reconstruct(const std::vector<long long>& residues) const;
+    BigInteger reconstructSigned(const std::vector<long long>& residues) const;
+    static std::optional<Rational> rationalReconstruct(
+        const BigInteger& value, const BigInteger& modulus);
+
+  private:
+    std::vector<long long> moduli_;
+    // tree_[0] holds the moduli, every next level the pairwise products of
+    // the previous one; tree_.back()[0] is the product of all moduli.
+    std::vector<std::vector<BigInteger>> tree_;
+    std::vector<long long> inverses_;
+};
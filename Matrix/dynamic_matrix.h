@@ -0,0 +1,336 @@
+#pragma once
+
+#include <cassert>
+#include <new>
+#include "matrix.h"
+
+const size_t MATRIX_ALIGNMENT = 64;
+
+template <typename T>
+class AlignedAllocator {
+  public:
+    using value_type = T;
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>& /*other*/) {}
+    T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(
+            count * sizeof(T), std::align_val_t(MATRIX_ALIGNMENT)));
+    }
+    void deallocate(T* pointer, size_t /*count*/) {
+        ::operator delete(pointer, std::align_val_t(MATRIX_ALIGNMENT));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const AlignedAllocator<T>& /*a*/,
+                const AlignedAllocator<U>& /*b*/) {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const AlignedAllocator<T>& /*a*/,
+                const AlignedAllocator<U>& /*b*/) {
+    return false;
+}
+
+// Matrix with dimensions chosen at runtime, stored row-major in one
+// cache-line aligned heap buffer; operator[] returns a pointer to a row.
+template <typename Field = Rational>
+class DynamicMatrix {
+  public:
+    DynamicMatrix() : DynamicMatrix(0, 0) {}
+    DynamicMatrix(size_t rows, size_t columns);
+    template <typename T>
+    DynamicMatrix(const std::initializer_list<std::initializer_list<T>>& il);
+    template <size_t M, size_t N>
+    explicit DynamicMatrix(const Matrix<M, N, Field>& m);
+    template <MatrixExpressionType Expression>
+    explicit DynamicMatrix(const Expression& expression)
+        : DynamicMatrix(ResultOf<Expression>(expression)) {}
+    static DynamicMatrix identity(size_t n);
+    size_t rows() const;
+    size_t columns() const;
+    DynamicMatrix& operator+=(const DynamicMatrix& other);
+    DynamicMatrix& operator-=(const DynamicMatrix& other);
+    DynamicMatrix& operator*=(const Field& other);
+    DynamicMatrix& operator*=(const DynamicMatrix& other);
+    Field det() const;
+    DynamicMatrix transposed() const;
+    size_t rank() const;
+    DynamicMatrix inverted() const;
+    void invert();
+    Field trace() const;
+    std::vector<Field> getRow(size_t row) const;
+    std::vector<Field> getColumn(size_t column) const;
+    StridedSpan<Field> column(size_t index);
+    StridedSpan<const Field> column(size_t index) const;
+    BlockView<Field> block(size_t row, size_t column, size_t rows,
+                           size_t columns);
+    BlockView<const Field> block(size_t row, size_t column, size_t rows,
+                                 size_t columns) const;
+    const Field* operator[](size_t index) const;
+    Field* operator[](size_t index);
+    size_t gaussForwardAndReverse(bool to_revert);
+
+  private:
+    size_t rows_;
+    size_t columns_;
+    std::vector<Field, AlignedAllocator<Field>> data_;
+};
+
+template <typename Field>
+DynamicMatrix<Field>::DynamicMatrix(size_t rows, size_t columns)
+    : rows_(rows), columns_(columns), data_(rows * columns, Field(0)) {}
+
+template <typename Field>
+template <typename T>
+DynamicMatrix<Field>::DynamicMatrix(
+    const std::initializer_list<std::initializer_list<T>>& il)
+    : DynamicMatrix(il.size(), il.size() == 0 ? 0 : il.begin()->size()) {
+    size_t i = 0;
+    for (auto row = il.begin(); row != il.end(); ++row) {
+        assert(row->size() == columns_);
+        size_t j = 0;
+        for (auto column = row->begin(); column != row->end(); ++column) {
+            (*this)[i][j] = Field(*column);
+            ++j;
+        }
+        ++i;
+    }
+}
+
+template <typename Field>
+template <size_t M, size_t N>
+DynamicMatrix<Field>::DynamicMatrix(const Matrix<M, N, Field>& m)
+    : DynamicMatrix(M, N) {
+    for (size_t i = 0; i < M; ++i) {
+        std::copy(m[i].begin(), m[i].end(), (*this)[i]);
+    }
+}
+
+template <typename Field>
+DynamicMatrix<Field> DynamicMatrix<Field>::identity(size_t n) {
+    DynamicMatrix result(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        result[i][i] = Field(1);
+    }
+    return result;
+}
+
+template <typename Field>
+size_t DynamicMatrix<Field>::rows() const {
+    return rows_;
+}
+
+template <typename Field>
+size_t DynamicMatrix<Field>::columns() const {
+    return columns_;
+}
+
+template <typename Field>
+DynamicMatrix<Field>& DynamicMatrix<Field>::operator+=(
+    const DynamicMatrix& other) {
+    assert(rows_ == other.rows_ && columns_ == other.columns_);
+    if constexpr (SIMD_FIELD<Field>) {
+        simdKernels<Field>().axpy(data_.data(), other.data_.data(), Field(1),
+                                  data_.size());
+        return *this;
+    }
+    for (size_t i = 0; i < data_.size(); ++i) {
+        data_[i] += other.data_[i];
+    }
+    return *this;
+}
+
+template <typename Field>
+DynamicMatrix<Field>& DynamicMatrix<Field>::operator-=(
+    const DynamicMatrix& other) {
+    assert(rows_ == other.rows_ && columns_ == other.columns_);
+    if constexpr (SIMD_FIELD<Field>) {
+        simdKernels<Field>().axpy(data_.data(), other.data_.data(), Field(-1),
+                                  data_.size());
+        return *this;
+    }
+    for (size_t i = 0; i < data_.size(); ++i) {
+        data_[i] -= other.data_[i];
+    }
+    return *this;
+}
+
+template <typename Field>
+DynamicMatrix<Field>& DynamicMatrix<Field>::operator*=(const Field& other) {
+    if constexpr (SIMD_FIELD<Field>) {
+        simdKernels<Field>().scale(data_.data(), other, data_.size());
+        return *this;
+    }
+    for (Field& value : data_) {
+        value *= other;
+    }
+    return *this;
+}
+
+template <typename Field>
+DynamicMatrix<Field>& DynamicMatrix<Field>::operator*=(
+    const DynamicMatrix& other) {
+    return *this = *this * other;
+}
+
+template <typename Field>
+DynamicMatrix<Field> operator*(const DynamicMatrix<Field>& a,
+                               const DynamicMatrix<Field>& b) {
+    assert(a.columns() == b.rows());
+    DynamicMatrix<Field> product(a.rows(), b.columns());
+    multiplyInto<Field>(a, b, product, a.rows(), a.columns(), b.columns());
+    return product;
+}
+
+template <typename Field>
+DynamicMatrix<Field> operator*(const Field& a, const DynamicMatrix<Field>& b) {
+    DynamicMatrix<Field> copy = b;
+    copy *= a;
+    return copy;
+}
+
+template <typename Field>
+DynamicMatrix<Field> operator+(const DynamicMatrix<Field>& a,
+                               const DynamicMatrix<Field>& b) {
+    DynamicMatrix<Field> copy = a;
+    copy += b;
+    return copy;
+}
+
+template <typename Field>
+DynamicMatrix<Field> operator-(const DynamicMatrix<Field>& a,
+                               const DynamicMatrix<Field>& b) {
+    DynamicMatrix<Field> copy = a;
+    copy -= b;
+    return copy;
+}
+
+template <typename Field>
+size_t DynamicMatrix<Field>::gaussForwardAndReverse(bool to_revert) {
+    return ::gaussForwardAndReverse<Field>(*this, rows_, columns_, to_revert);
+}
+
+template <typename Field>
+Field DynamicMatrix<Field>::det() const {
+    assert(rows_ == columns_);
+    return detOf<Field>(*this, rows_);
+}
+
+template <typename Field>
+DynamicMatrix<Field> DynamicMatrix<Field>::transposed() const {
+    DynamicMatrix copy(columns_, rows_);
+    for (size_t i = 0; i < columns_; ++i) {
+        for (size_t j = 0; j < rows_; ++j) {
+            copy[i][j] = (*this)[j][i];
+        }
+    }
+    return copy;
+}
+
+template <typename Field>
+size_t DynamicMatrix<Field>::rank() const {
+    return rankOf<Field>(*this, rows_, columns_);
+}
+
+template <typename Field>
+DynamicMatrix<Field> DynamicMatrix<Field>::inverted() const {
+    DynamicMatrix copy = *this;
+    copy.invert();
+    return copy;
+}
+
+template <typename Field>
+void DynamicMatrix<Field>::invert() {
+    assert(rows_ == columns_);
+    invertInto<Field>(*this, rows_, *this);
+}
+
+template <typename Field>
+Field DynamicMatrix<Field>::trace() const {
+    assert(rows_ == columns_);
+    Field trace(0);
+    for (size_t i = 0; i < rows_; ++i) {
+        trace += (*this)[i][i];
+    }
+    return trace;
+}
+
+template <typename Field>
+std::vector<Field> DynamicMatrix<Field>::getRow(size_t row) const {
+    return std::vector<Field>((*this)[row], (*this)[row] + columns_);
+}
+
+template <typename Field>
+std::vector<Field> DynamicMatrix<Field>::getColumn(size_t column) const {
+    std::vector<Field> copy(rows_);
+    for (size_t j = 0; j < rows_; ++j) {
+        copy[j] = (*this)[j][column];
+    }
+    return copy;
+}
+
+template <typename Field>
+StridedSpan<Field> DynamicMatrix<Field>::column(size_t index) {
+    return {data_.data() + index, columns_, rows_};
+}
+
+template <typename Field>
+StridedSpan<const Field> DynamicMatrix<Field>::column(size_t index) const {
+    return {data_.data() + index, columns_, rows_};
+}
+
+template <typename Field>
+BlockView<Field> DynamicMatrix<Field>::block(size_t row, size_t column,
+                                             size_t rows, size_t columns) {
+    return {(*this)[row] + column, columns_, rows, columns};
+}
+
+template <typename Field>
+BlockView<const Field> DynamicMatrix<Field>::block(size_t row, size_t column,
+                                                   size_t rows,
+                                                   size_t columns) const {
+    return {(*this)[row] + column, columns_, rows, columns};
+}
+
+template <typename Field>
+const Field* DynamicMatrix<Field>::operator[](size_t index) const {
+    return data_.data() + index * columns_;
+}
+
+template <typename Field>
+Field* DynamicMatrix<Field>::operator[](size_t index) {
+    return data_.data() + index * columns_;
+}
+
+template <typename Field>
+bool operator==(const DynamicMatrix<Field>& a, const DynamicMatrix<Field>& b) {
+    if (a.rows() != b.rows() || a.columns() != b.columns()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.rows(); ++i) {
+        for (size_t j = 0; j < a.columns(); ++j) {
+            if (a[i][j] != b[i][j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Reads "rows columns" followed by the entries in row-major order.
+template <typename Field>
+std::istream& operator>>(std::istream& in, DynamicMatrix<Field>& m) {
+    size_t rows = 0;
+    size_t columns = 0;
+    in >> rows >> columns;
+    m = DynamicMatrix<Field>(rows, columns);
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < columns; ++j) {
+            in >> m[i][j];
+        }
+    }
+    return in;
+}
@@ -0,0 +1,150 @@
+#include "limb_allocator.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <new>
+
+namespace {
+
+const size_t MIN_BLOCK = 32;
+const size_t CLASS_COUNT = 10;
+const size_t MAX_CACHED = 64;
+
+void* defaultAllocate(size_t bytes) {
+    return ::operator new(bytes);
+}
+
+void defaultDeallocate(void* pointer, size_t /*bytes*/) {
+    ::operator delete(pointer);
+}
+
+struct AtomicResource {
+    std::atomic<void* (*)(size_t)> allocate{defaultAllocate};
+    std::atomic<void (*)(void*, size_t)> deallocate{defaultDeallocate};
+};
+
+AtomicResource& resource() {
+    static AtomicResource resource;
+    return resource;
+}
+
+std::atomic<bool>& poolEnabled() {
+    static std::atomic<bool> enabled(true);
+    return enabled;
+}
+
+void* upstreamAllocate(size_t bytes) {
+    return resource().allocate.load(std::memory_order_relaxed)(bytes);
+}
+
+void upstreamDeallocate(void* pointer, size_t bytes) {
+    resource().deallocate.load(std::memory_order_relaxed)(pointer, bytes);
+}
+
+class LimbPool {
+  public:
+    LimbPool() = default;
+    LimbPool(const LimbPool&) = delete;
+    LimbPool& operator=(const LimbPool&) = delete;
+
+    ~LimbPool() {
+        for (size_t i = 0; i < CLASS_COUNT; ++i) {
+            while (heads_[i] != nullptr) {
+                FreeBlock* next = heads_[i]->next;
+                upstreamDeallocate(heads_[i], MIN_BLOCK << i);
+                heads_[i] = next;
+            }
+        }
+        destroyed() = true;
+    }
+
+    static bool& destroyed() {
+        static thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    void* allocate(size_t size_class) {
+        if (heads_[size_class] == nullptr) {
+            return upstreamAllocate(MIN_BLOCK << size_class);
+        }
+        FreeBlock* block = heads_[size_class];
+        heads_[size_class] = block->next;
+        --counts_[size_class];
+        return block;
+    }
+
+    void deallocate(void* pointer, size_t size_class) {
+        if (counts_[size_class] == MAX_CACHED) {
+            upstreamDeallocate(pointer, MIN_BLOCK << size_class);
+            return;
+        }
+        heads_[size_class] = new (pointer) FreeBlock{heads_[size_class]};
+        ++counts_[size_class];
+    }
+
+  private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+    std::array<FreeBlock*, CLASS_COUNT> heads_{};
+    std::array<size_t, CLASS_COUNT> counts_{};
+};
+
+// Returns nullptr once the calling thread's pool has been destroyed, so
+// buffers released during thread or program shutdown go straight upstream.
+LimbPool* threadPool() {
+    if (!poolEnabled().load(std::memory_order_relaxed) ||
+        LimbPool::destroyed()) {
+        return nullptr;
+    }
+    static thread_local LimbPool pool;
+    return &pool;
+}
+
+size_t sizeClass(size_t bytes) {
+    return std::countr_zero(std::bit_ceil(std::max(bytes, MIN_BLOCK)) /
+                            MIN_BLOCK);
+}
+
+}  // namespace
+
+void setLimbResource(LimbResource resource_hooks) {
+    resource().allocate.store(resource_hooks.allocate);
+    resource().deallocate.store(resource_hooks.deallocate);
+}
+
+LimbResource getLimbResource() {
+    return {resource().allocate.load(), resource().deallocate.load()};
+}
+
+void setLimbPoolEnabled(bool enabled) {
+    poolEnabled().store(enabled);
+}
+
+void* allocateLimbs(size_t bytes) {
+    size_t size_class = sizeClass(bytes);
+    if (size_class >= CLASS_COUNT) {
+        return upstreamAllocate(bytes);
+    }
+    LimbPool* pool = threadPool();
+    if (pool == nullptr) {
+        return upstreamAllocate(MIN_BLOCK << size_class);
+    }
+    return pool->allocate(size_class);
+}
+
+void deallocateLimbs(void* pointer, size_t bytes) {
+    size_t size_class = sizeClass(bytes);
+    if (size_class >= CLASS_COUNT) {
+        upstreamDeallocate(pointer, bytes);
+        return;
+    }
+    LimbPool* pool = threadPool();
+    if (pool == nullptr) {
+        upstreamDeallocate(pointer, MIN_BLOCK << size_class);
+        return;
+    }
+    pool->deallocate(pointer, size_class);
+}
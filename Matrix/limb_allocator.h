@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+
+struct LimbResource {
+    void* (*allocate)(size_t bytes);
+    void (*deallocate)(void* pointer, size_t bytes);
+};
+
+// The resource backs every thread's pool. Blocks are returned to whichever
+// resource is installed when they are released, so replace it only while no
+// thread that will release blocks holds any from the previous one: before
+// any limb buffer is allocated, or around work confined to a new thread.
+void setLimbResource(LimbResource resource);
+LimbResource getLimbResource();
+void setLimbPoolEnabled(bool enabled);
+void* allocateLimbs(size_t bytes);
+void deallocateLimbs(void* pointer, size_t bytes);
+
+template <typename T>
+class LimbAllocator {
+  public:
+    using value_type = T;
+    LimbAllocator() = default;
+    template <typename U>
+    LimbAllocator(const LimbAllocator<U>& /*other*/) {}
+    T* allocate(size_t count) {
+        return static_cast<T*>(allocateLimbs(count * sizeof(T)));
+    }
+    void deallocate(T* pointer, size_t count) {
+        deallocateLimbs(pointer, count * sizeof(T));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const LimbAllocator<T>& /*a*/, const LimbAllocator<U>& /*b*/) {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const LimbAllocator<T>& /*a*/, const LimbAllocator<U>& /*b*/) {
+    return false;
+}
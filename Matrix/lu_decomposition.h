@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include "matrix.h"
+
+// PA = LU computed once; det and rank are then O(1) and every solve is
+// O(n^2) per right-hand side. L has a unit diagonal and shares storage with
+// U. Floating-point fields pick the largest pivot in the column, exact ones
+// the first nonzero. Singular matrices are factored as far as their rank:
+// multipliers of the k-th pivot form column k of L and U is in row echelon
+// form, zero below row rank().
+template <size_t N, typename Field = Rational>
+class LUDecomposition {
+  public:
+    explicit LUDecomposition(const SquareMatrix<N, Field>& a);
+    Field det() const;
+    size_t rank() const;
+    bool singular() const;
+    const std::vector<size_t>& permutation() const;
+    SquareMatrix<N, Field> lower() const;
+    SquareMatrix<N, Field> upper() const;
+    template <size_t K>
+    Matrix<N, K, Field> solve(const Matrix<N, K, Field>& b) const;
+    std::array<Field, N> solve(const std::array<Field, N>& b) const;
+    SquareMatrix<N, Field> inverted() const;
+
+  private:
+    size_t findPivot(size_t column) const;
+    std::vector<Field> lu_;
+    std::vector<size_t> permutation_;
+    std::vector<Field> pivot_inverses_;
+    Field det_;
+    size_t rank_ = 0;
+};
+
+template <size_t N, typename Field>
+LUDecomposition<N, Field>::LUDecomposition(const SquareMatrix<N, Field>& a)
+    : lu_(N * N), permutation_(N), det_(1) {
+    for (size_t i = 0; i < N; ++i) {
+        std::copy(a[i].begin(), a[i].end(), lu_.begin() + i * N);
+        permutation_[i] = i;
+    }
+    StridedRows<Field> rows{lu_.data(), N};
+    for (size_t c = 0; c < N; ++c) {
+        size_t r = rank_;
+        size_t pivot = findPivot(c);
+        if (pivot == N) {
+            continue;
+        }
+        if (pivot != r) {
+            std::swap_ranges(rows[pivot], rows[pivot] + N, rows[r]);
+            std::swap(permutation_[pivot], permutation_[r]);
+            det_ *= Field(-1);
+        }
+        det_ *= rows[r][c];
+        Field pivot_inverse = inverse(rows[r][c]);
+        auto eliminate = [&rows, &pivot_inverse, r, c](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                if (rows[i][c] == Field(0)) {
+                    continue;
+                }
+                Field factor = rows[i][c] * pivot_inverse;
+                rows[i][c] = Field(0);
+                rows[i][r] = factor;
+                subtractRow(rows, i, r, factor, c + 1, N);
+            }
+        };
+        parallelRows(r + 1, N, (N - r - 1) * (N - c), eliminate);
+        pivot_inverses_.push_back(pivot_inverse);
+        ++rank_;
+    }
+    if (rank_ < N) {
+        det_ = Field(0);
+    }
+}
+
+template <size_t N, typename Field>
+size_t LUDecomposition<N, Field>::findPivot(size_t column) const {
+    size_t pivot = N;
+    for (size_t i = rank_; i < N; ++i) {
+        const Field& value = lu_[i * N + column];
+        if (value == Field(0)) {
+            continue;
+        }
+        if constexpr (!std::is_floating_point_v<Field>) {
+            return i;
+        } else if (pivot == N ||
+                   std::abs(value) > std::abs(lu_[pivot * N + column])) {
+            pivot = i;
+        }
+    }
+    return pivot;
+}
+
+template <size_t N, typename Field>
+Field LUDecomposition<N, Field>::det() const {
+    return det_;
+}
+
+template <size_t N, typename Field>
+size_t LUDecomposition<N, Field>::rank() const {
+    return rank_;
+}
+
+template <size_t N, typename Field>
+bool LUDecomposition<N, Field>::singular() const {
+    return rank_ < N;
+}
+
+template <size_t N, typename Field>
+const std::vector<size_t>& LUDecomposition<N, Field>::permutation() const {
+    return permutation_;
+}
+
+template <size_t N, typename Field>
+SquareMatrix<N, Field> LUDecomposition<N, Field>::lower() const {
+    SquareMatrix<N, Field> lower;
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            lower[i][j] = lu_[i * N + j];
+        }
+        lower[i][i] = Field(1);
+    }
+    return lower;
+}
+
+template <size_t N, typename Field>
+SquareMatrix<N, Field> LUDecomposition<N, Field>::upper() const {
+    SquareMatrix<N, Field> upper;
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = i; j < N; ++j) {
+            upper[i][j] = lu_[i * N + j];
+        }
+    }
+    return upper;
+}
+
+// Forward and back substitution on whole rows of b, so all K right-hand
+// sides are updated by one contiguous loop.
+template <size_t N, typename Field>
+template <size_t K>
+Matrix<N, K, Field> LUDecomposition<N, Field>::solve(
+    const Matrix<N, K, Field>& b) const {
+    assert(!singular());
+    Matrix<N, K, Field> x;
+    for (size_t i = 0; i < N; ++i) {
+        x[i] = b[permutation_[i]];
+        for (size_t j = 0; j < i; ++j) {
+            const Field& factor = lu_[i * N + j];
+            if (factor == Field(0)) {
+                continue;
+            }
+            for (size_t k = 0; k < K; ++k) {
+                x[i][k] -= factor * x[j][k];
+            }
+        }
+    }
+    for (size_t i = N; i > 0; --i) {
+        size_t row = i - 1;
+        for (size_t j = i; j < N; ++j) {
+            const Field& factor = lu_[row * N + j];
+            if (factor == Field(0)) {
+                continue;
+            }
+            for (size_t k = 0; k < K; ++k) {
+                x[row][k] -= factor * x[j][k];
+            }
+        }
+        for (size_t k = 0; k < K; ++k) {
+            x[row][k] *= pivot_inverses_[row];
+        }
+    }
+    return x;
+}
+
+template <size_t N, typename Field>
+std::array<Field, N> LUDecomposition<N, Field>::solve(
+    const std::array<Field, N>& b) const {
+    Matrix<N, 1, Field> column;
+    for (size_t i = 0; i < N; ++i) {
+        column[i][0] = b[i];
+    }
+    return solve(column).getColumn(0);
+}
+
+template <size_t N, typename Field>
+SquareMatrix<N, Field> LUDecomposition<N, Field>::inverted() const {
+    SquareMatrix<N, Field> identity;
+    for (size_t i = 0; i < N; ++i) {
+        identity[i][i] = Field(1);
+    }
+    return solve(identity);
+}
@@ -1,57 +1,158 @@
+#pragma once
+
 #include <array>
+#include <cmath>
+#include <concepts>
+#include <numeric>
+#include <span>
+#include <vector>
+#include "bareiss.h"
 #include "biginteger.h"
-
-template <size_t N, size_t Divisor, bool signal = false>
-struct isPrimeHelper {
-    static const bool value =
-        (N % Divisor != 0) &&
-        isPrimeHelper<N, Divisor + 1, Divisor * Divisor >= N>::value;
-};
-
-template <size_t N, size_t Divisor>
-struct isPrimeHelper<N, Divisor, true> {
-    static const bool value = true;
-};
-
-template <>
-struct isPrimeHelper<1, 2, false> {
-    static const bool value = false;
-};
-
-template <>
-struct isPrimeHelper<2, 2, false> {
-    static const bool value = true;
-};
+#include "modular.h"
+#include "simd.h"
+#include "thread_pool.h"
 
 template <size_t N>
-const bool isPrime = isPrimeHelper<N, 2, false>::value;
+constexpr bool isPrime = isPrimeNumber(N);
 
 template <size_t N>
 class Residue {
   public:
-    explicit Residue(int n);
+    class Accumulator;
+    explicit Residue(long long n);
     explicit operator int() const;
+    explicit operator long long() const;
     Residue() : Residue(0) {}
     ~Residue() = default;
     Residue<N>& operator+=(const Residue<N>& n);
     Residue<N>& operator-=(const Residue<N>& n);
     Residue<N>& operator*=(const Residue<N>& n);
     Residue<N>& operator/=(const Residue<N>& n);
+    Residue<N> inverse() const;
     template <size_t S>
     friend bool operator==(const Residue<S>& n1, const Residue<S>& n2);
     template <size_t S>
     friend std::ostream& operator<<(std::ostream& out, const Residue<S>& n);
 
   private:
-    long long value_;
+    static_assert(N > 0 && N < (1ULL << 63), "Residue: modulus out of range");
+    using Wide = unsigned __int128;
+    // Odd moduli that do not fit in 32 bits are kept in Montgomery form
+    // (value_ = a * 2^64 mod N) so products avoid a 128-bit division.
+    static constexpr bool MONTGOMERY_ = N >= (1ULL << 32) && N % 2 == 1;
+    static constexpr uint64_t NEGATED_INVERSE_ =
+        0 - inverseModWord(MONTGOMERY_ ? N : 1);
+    static constexpr uint64_t R_ = (0 - static_cast<uint64_t>(N)) % N;
+    static constexpr uint64_t R2_ = mulMod(R_, R_, N);
+    static constexpr uint64_t R3_ = mulMod(R2_, R_, N);
+    static uint64_t reduce(Wide product);
+    static uint64_t multiply(uint64_t a, uint64_t b);
+    uint64_t value_;
+};
+
+template <typename Field>
+Field inverse(const Field& value) {
+    if constexpr (requires { value.inverse(); }) {
+        return value.inverse();
+    } else {
+        return Field(1) / value;
+    }
+}
+
+// Montgomery's trick: replaces every nonzero entry with its inverse using a
+// single inversion and 3(n - 1) multiplications.
+template <typename Field>
+void batchInverse(std::vector<Field>& values) {
+    if (values.empty()) {
+        return;
+    }
+    std::vector<Field> prefix(values.size());
+    prefix[0] = values[0];
+    for (size_t i = 1; i < values.size(); ++i) {
+        prefix[i] = prefix[i - 1] * values[i];
+    }
+    Field running = inverse(prefix.back());
+    for (size_t i = values.size() - 1; i > 0; --i) {
+        Field value_inverse = running * prefix[i - 1];
+        running *= values[i];
+        values[i] = value_inverse;
+    }
+    values[0] = running;
+}
+
+// Non-owning views into row-major storage: a strided run of entries (e.g. a
+// column) and a rectangular block whose rows are row pointers, so blocks
+// plug into the row-indexable kernels below.
+template <typename Field>
+struct StridedSpan {
+    Field* data;
+    size_t stride;
+    size_t size;
+    Field& operator[](size_t index) const {
+        return data[index * stride];
+    }
+};
+
+template <typename Field>
+struct BlockView {
+    Field* data;
+    size_t stride;
+    size_t rows;
+    size_t columns;
+    Field* operator[](size_t row) const {
+        return data + row * stride;
+    }
 };
 
+template <size_t M, size_t N, typename Field>
+class Matrix;
+
+template <size_t M, size_t N, typename Field>
+class TransposedView;
+
+template <typename T>
+constexpr bool isMatrix = false;
+
+template <size_t M, size_t N, typename Field>
+constexpr bool isMatrix<Matrix<M, N, Field>> = true;
+
+// Lazy results of matrix arithmetic: elementwise expressions expose at(i, j)
+// and are evaluated in one fused pass; the others (products) implement
+// assignTo/addTo and write straight into the destination. CELLWISE ones
+// read only cell (i, j) of their operands for at(i, j).
+template <typename T>
+concept MatrixExpressionType = !isMatrix<T> && requires(const T& e) {
+    typename T::FieldType;
+    { T::ROWS } -> std::convertible_to<size_t>;
+    { T::COLUMNS } -> std::convertible_to<size_t>;
+    { T::ELEMENTWISE } -> std::convertible_to<bool>;
+    { T::CELLWISE } -> std::convertible_to<bool>;
+    { e.aliases(nullptr) } -> std::convertible_to<bool>;
+};
+
+template <typename T, size_t M, size_t N, typename Field>
+concept MatrixExpressionOf =
+    MatrixExpressionType<T> && T::ROWS == M && T::COLUMNS == N &&
+    std::is_same_v<typename T::FieldType, Field>;
+
 template <size_t M, size_t N, typename Field = Rational>
 class Matrix {
   public:
+    static constexpr size_t ROWS = M;
+    static constexpr size_t COLUMNS = N;
+    using FieldType = Field;
     Matrix() = default;
     ~Matrix() = default;
     Matrix(const Matrix& m);
+    Matrix& operator=(const Matrix& m) = default;
+    template <MatrixExpressionOf<M, N, Field> Expression>
+    Matrix(const Expression& expression);
+    template <MatrixExpressionOf<M, N, Field> Expression>
+    Matrix& operator=(const Expression& expression);
+    template <MatrixExpressionOf<M, N, Field> Expression>
+    Matrix& operator+=(const Expression& expression);
+    template <MatrixExpressionOf<M, N, Field> Expression>
+    Matrix& operator-=(const Expression& expression);
     template <typename T>
     Matrix(const std::initializer_list<std::initializer_list<T>>& il);
     Matrix<M, N, Field>& operator+=(const Matrix<M, N, Field>& other);
@@ -60,6 +161,16 @@ class Matrix {
     Matrix<M, N, Field>& operator*=(const Matrix<N, N, Field>& other);
     Field det() const;
     Matrix<N, M, Field> transposed() const;
+    TransposedView<M, N, Field> transposedView() const&;
+    TransposedView<M, N, Field> transposedView() && = delete;
+    std::span<Field, N> row(size_t index);
+    std::span<const Field, N> row(size_t index) const;
+    StridedSpan<Field> column(size_t index);
+    StridedSpan<const Field> column(size_t index) const;
+    BlockView<Field> block(size_t row, size_t column, size_t rows,
+                           size_t columns);
+    BlockView<const Field> block(size_t row, size_t column, size_t rows,
+                                 size_t columns) const;
     size_t rank() const;
     Matrix<M, N, Field> inverted() const;
     void invert();
@@ -72,53 +183,270 @@ class Matrix {
     Matrix<M, N, Field>& sumSub(bool plus, const Matrix<M, N, Field>& other);
 
   private:
-    std::array<std::array<Field, N>, M> matrix_;
+    std::array<std::array<Field, N>, M> matrix_{};
 };
 
 template <size_t N, typename Field = Rational>
 using SquareMatrix = Matrix<N, N, Field>;
 
+const size_t MULTIPLY_BLOCK = 64;
+// Column tile of the SIMD product: wider, so that each kernel call does
+// enough work to amortize the indirect call.
+const size_t SIMD_BLOCK = 256;
+
+// float and double rows stored contiguously (arrays, spans or row pointers)
+// go through the vector kernels of simd.h.
+template <typename Field>
+constexpr bool SIMD_FIELD =
+    std::is_same_v<Field, float> || std::is_same_v<Field, double>;
+
+template <typename Rows>
+concept ContiguousRows =
+    std::is_pointer_v<
+        std::remove_cvref_t<decltype(std::declval<Rows&>()[0])>> ||
+    requires(Rows& rows) { std::data(rows[0]); };
+
+template <typename Row>
+auto rowData(Row&& row) {
+    if constexpr (std::is_pointer_v<std::remove_cvref_t<Row>>) {
+        return row;
+    } else {
+        return std::data(row);
+    }
+}
+
+// c += a * b on rows [row_begin, row_end) for row-indexable a (rows x
+// inner) and b (inner x columns), tiled so that one block of b stays in
+// L1/L2 while it is reused across a block of rows; the innermost loop walks
+// rows of b and c contiguously.
+// Fields with an Accumulator (Residue) sum a whole row-by-column product
+// unreduced and reduce once per result cell; float and double rows are
+// updated by the SIMD axpy kernel. A transposed b exposing source() is
+// multiplied by dot products of contiguous rows.
+template <typename Field, typename A, typename B, typename C>
+void multiplyRows(const A& a, const B& b, C& c, size_t row_begin,
+                  size_t row_end, size_t inner, size_t columns) {
+    if constexpr (requires { b.source(); }) {
+        const auto& b_transposed = b.source();
+        for (size_t i = row_begin; i < row_end; ++i) {
+            const auto& a_row = a[i];
+            auto&& c_row = c[i];
+            for (size_t j = 0; j < columns; ++j) {
+                const auto& b_column = b_transposed[j];
+                if constexpr (SIMD_FIELD<Field> && ContiguousRows<const A>) {
+                    c_row[j] += simdKernels<Field>().dot(
+                        rowData(a_row), rowData(b_column), inner);
+                } else if constexpr (requires {
+                                         typename Field::Accumulator;
+                                     }) {
+                    typename Field::Accumulator sum;
+                    for (size_t k = 0; k < inner; ++k) {
+                        sum.add(a_row[k], b_column[k]);
+                    }
+                    c_row[j] += sum.get();
+                } else {
+                    Field sum(0);
+                    for (size_t k = 0; k < inner; ++k) {
+                        sum += a_row[k] * b_column[k];
+                    }
+                    c_row[j] += sum;
+                }
+            }
+        }
+        return;
+    }
+    if constexpr (SIMD_FIELD<Field> && ContiguousRows<const A> &&
+                  ContiguousRows<const B> && ContiguousRows<C>) {
+        const SimdKernels<Field>& kernels = simdKernels<Field>();
+        for (size_t kk = 0; kk < inner; kk += MULTIPLY_BLOCK) {
+            size_t k_end = std::min(kk + MULTIPLY_BLOCK, inner);
+            for (size_t jj = 0; jj < columns; jj += SIMD_BLOCK) {
+                size_t j_end = std::min(jj + SIMD_BLOCK, columns);
+                for (size_t i = row_begin; i < row_end; ++i) {
+                    Field* c_row = rowData(c[i]);
+                    const Field* a_row = rowData(a[i]);
+                    for (size_t k = kk; k < k_end; ++k) {
+                        kernels.axpy(c_row + jj, rowData(b[k]) + jj, a_row[k],
+                                     j_end - jj);
+                    }
+                }
+            }
+        }
+        return;
+    }
+    if constexpr (requires { typename Field::Accumulator; }) {
+        std::vector<typename Field::Accumulator> sums(MULTIPLY_BLOCK);
+        for (size_t jj = 0; jj < columns; jj += MULTIPLY_BLOCK) {
+            size_t j_end = std::min(jj + MULTIPLY_BLOCK, columns);
+            for (size_t i = row_begin; i < row_end; ++i) {
+                std::fill(sums.begin(), sums.end(),
+                          typename Field::Accumulator());
+                const auto& a_row = a[i];
+                for (size_t k = 0; k < inner; ++k) {
+                    const Field& a_ik = a_row[k];
+                    const auto& b_row = b[k];
+                    for (size_t j = jj; j < j_end; ++j) {
+                        sums[j - jj].add(a_ik, b_row[j]);
+                    }
+                }
+                auto&& c_row = c[i];
+                for (size_t j = jj; j < j_end; ++j) {
+                    c_row[j] += sums[j - jj].get();
+                }
+            }
+        }
+        return;
+    }
+    for (size_t kk = 0; kk < inner; kk += MULTIPLY_BLOCK) {
+        size_t k_end = std::min(kk + MULTIPLY_BLOCK, inner);
+        for (size_t jj = 0; jj < columns; jj += MULTIPLY_BLOCK) {
+            size_t j_end = std::min(jj + MULTIPLY_BLOCK, columns);
+            for (size_t i = row_begin; i < row_end; ++i) {
+                auto&& c_row = c[i];
+                const auto& a_row = a[i];
+                for (size_t k = kk; k < k_end; ++k) {
+                    const Field& a_ik = a_row[k];
+                    const auto& b_row = b[k];
+                    for (size_t j = jj; j < j_end; ++j) {
+                        c_row[j] += a_ik * b_row[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Independent row bands of c are handed to the thread pool once the
+// product is large enough.
+template <typename Field, typename A, typename B, typename C>
+void multiplyAccumulate(const A& a, const B& b, C& c, size_t rows,
+                        size_t inner, size_t columns) {
+    parallelRows(0, rows, rows * inner * columns,
+                 [&a, &b, &c, inner, columns](size_t lo, size_t hi) {
+                     multiplyRows<Field>(a, b, c, lo, hi, inner, columns);
+                 });
+}
+
+template <size_t N>
+class Residue<N>::Accumulator {
+  public:
+    void add(const Residue<N>& a, const Residue<N>& b);
+    Residue<N> get() const;
+
+  private:
+    static constexpr uint64_t LAZY_LIMIT_ = (1ULL << 63) / N * N;
+    std::conditional_t<(N < (1ULL << 31)), uint64_t, Wide> sum_ = 0;
+};
+
+template <size_t N>
+uint64_t Residue<N>::reduce(Wide product) {
+    uint64_t m = static_cast<uint64_t>(product) * NEGATED_INVERSE_;
+    auto result = static_cast<uint64_t>(
+        (product + static_cast<Wide>(m) * N) >> 64);
+    return result >= N ? result - N : result;
+}
+
+template <size_t N>
+uint64_t Residue<N>::multiply(uint64_t a, uint64_t b) {
+    if constexpr (MONTGOMERY_) {
+        return reduce(static_cast<Wide>(a) * b);
+    } else if constexpr (N < (1ULL << 32)) {
+        return a * b % N;
+    } else {
+        return static_cast<uint64_t>(static_cast<Wide>(a) * b % N);
+    }
+}
+
+template <size_t N>
+Residue<N>::Residue(long long n) {
+    long long value = n % static_cast<long long>(N);
+    value_ = static_cast<uint64_t>(value < 0 ? value + N : value);
+    if constexpr (MONTGOMERY_) {
+        value_ = reduce(static_cast<Wide>(value_) * R2_);
+    }
+}
+
 template <size_t N>
-Residue<N>::Residue(int n) : value_(n % static_cast<long long>(N)) {
-    value_ += (value_ < 0 ? N : 0);
+Residue<N>::operator long long() const {
+    if constexpr (MONTGOMERY_) {
+        return static_cast<long long>(reduce(value_));
+    }
+    return static_cast<long long>(value_);
 }
 
 template <size_t N>
 Residue<N>::operator int() const {
-    return static_cast<int>(value_);
+    return static_cast<int>(static_cast<long long>(*this));
 }
 
 template <size_t N>
 Residue<N>& Residue<N>::operator+=(const Residue<N>& n) {
-    value_ = (value_ + n.value_) % N;
+    value_ += n.value_;
+    if (value_ >= N) {
+        value_ -= N;
+    }
     return *this;
 }
 
 template <size_t N>
 Residue<N>& Residue<N>::operator-=(const Residue<N>& n) {
-    value_ = (value_ + N - n.value_) % N;
+    value_ = value_ >= n.value_ ? value_ - n.value_ : value_ + N - n.value_;
     return *this;
 }
 
 template <size_t N>
 Residue<N>& Residue<N>::operator*=(const Residue<N>& n) {
-    value_ = (value_ * n.value_) % N;
+    value_ = multiply(value_, n.value_);
     return *this;
 }
 
 template <size_t N>
-Residue<N>& Residue<N>::operator/=(const Residue<N>& n) {
+Residue<N> Residue<N>::inverse() const {
     static_assert(isPrime<N>, "Division: it's not a Field");
-    Residue<N> base(n);
-    ssize_t exponent = N - 2;
-    while (exponent != 0) {
-        if ((exponent & 1) != 0) {
-            *this *= base;
+    Residue<N> result;
+    result.value_ = inverseMod(value_, N);
+    if constexpr (MONTGOMERY_) {
+        // value_ = a * R, so its plain inverse is a^-1 * R^-1.
+        result.value_ = reduce(static_cast<Wide>(result.value_) * R3_);
+    }
+    return result;
+}
+
+template <size_t N>
+Residue<N>& Residue<N>::operator/=(const Residue<N>& n) {
+    return *this *= n.inverse();
+}
+
+// Sums products without reducing each one. Below 2^31 a 64-bit sum is kept
+// under 2^63 by subtracting a fixed multiple of N, below 2^32 a 128-bit sum
+// is reduced once in get(), and above that it is kept under N * 2^64 by
+// subtracting N * 2^64 (a no-op modulo N and valid input for reduce()).
+template <size_t N>
+void Residue<N>::Accumulator::add(const Residue<N>& a, const Residue<N>& b) {
+    if constexpr (N < (1ULL << 31)) {
+        sum_ += a.value_ * b.value_;
+        if (sum_ >= LAZY_LIMIT_) {
+            sum_ -= LAZY_LIMIT_;
+        }
+    } else if constexpr (N < (1ULL << 32)) {
+        sum_ += a.value_ * b.value_;
+    } else {
+        sum_ += static_cast<Wide>(a.value_) * b.value_;
+        if (sum_ >= (static_cast<Wide>(N) << 64)) {
+            sum_ -= static_cast<Wide>(N) << 64;
         }
-        exponent >>= 1;
-        base *= base;
     }
-    return *this;
+}
+
+template <size_t N>
+Residue<N> Residue<N>::Accumulator::get() const {
+    Residue<N> result;
+    if constexpr (MONTGOMERY_) {
+        result.value_ = reduce(sum_);
+    } else {
+        result.value_ = static_cast<uint64_t>(sum_ % N);
+    }
+    return result;
 }
 
 template <size_t N>
@@ -156,12 +484,12 @@ bool operator==(const Residue<S>& n1, const Residue<S>& n2) {
 
 template <size_t S>
 bool operator!=(const Residue<S>& n1, const Residue<S>& n2) {
-    return !(n1.value_ == n2.value_);
+    return !(n1 == n2);
 }
 
 template <size_t N>
 std::ostream& operator<<(std::ostream& out, const Residue<N>& n) {
-    out << n.value_;
+    out << static_cast<long long>(n);
     return out;
 }
 
@@ -183,52 +511,287 @@ Matrix<M, N, Field>::Matrix(
     }
 }
 
-template <size_t M, size_t N, typename Field>
-size_t Matrix<M, N, Field>::gaussForwardAndReverse(bool to_revert) {
-    size_t count_swaps = 0;
-    for (size_t i = 0; i < std::min(M, N); ++i) {
-        size_t j = i;
-        if (matrix_[i][i] == Field(0)) {
-            for (j = i + 1; j < M; ++j) {
-                if (matrix_[j][i] != Field(0)) {
-                    break;
-                }
-            }
+inline std::vector<size_t> identityOrder(size_t size) {
+    std::vector<size_t> order(size);
+    std::iota(order.begin(), order.end(), 0);
+    return order;
+}
+
+// Row at or below row to pivot column on: the first nonzero for exact
+// fields, the largest in magnitude for floating-point ones (partial
+// pivoting, which bounds the growth of rounding errors). m if none.
+template <typename Field, typename Rows>
+size_t pivotRow(Rows& rows, const std::vector<size_t>& order, size_t row,
+                size_t column, size_t m) {
+    size_t pivot = m;
+    for (size_t j = row; j < m; ++j) {
+        const Field& value = rows[order[j]][column];
+        if (value == Field(0)) {
+            continue;
         }
-        if (j == M) {
+        if constexpr (!std::is_floating_point_v<Field>) {
+            return j;
+        } else if (pivot == m ||
+                   std::abs(value) > std::abs(rows[order[pivot]][column])) {
+            pivot = j;
+        }
+    }
+    return pivot;
+}
+
+// rows[target][h] -= factor * rows[source][h] for h in [from, n).
+template <typename Field, typename Rows>
+void subtractRow(Rows& rows, size_t target, size_t source,
+                 const Field& factor, size_t from, size_t n) {
+    if constexpr (SIMD_FIELD<Field> && ContiguousRows<Rows>) {
+        simdKernels<Field>().axpy(rowData(rows[target]) + from,
+                                  rowData(rows[source]) + from, -factor,
+                                  n - from);
+    } else {
+        auto&& row = rows[target];
+        for (size_t h = from; h < n; ++h) {
+            row[h] -= factor * rows[source][h];
+        }
+    }
+}
+
+// Gaussian elimination on the first m rows and n columns of a
+// row-indexable matrix, where logical row i is rows[order[i]]: pivoting
+// swaps entries of order instead of moving rows. The result is in row
+// echelon form, so a column without a pivot does not use up a row. With
+// to_revert (for nonsingular square parts) the pivot columns are also
+// cleared above the diagonal. Returns the number of swaps.
+template <typename Field, typename Rows>
+size_t gaussEliminate(Rows&& rows, std::vector<size_t>& order, size_t m,
+                      size_t n, bool to_revert) {
+    size_t count_swaps = 0;
+    size_t i = 0;
+    for (size_t c = 0; c < n && i < m; ++c) {
+        size_t j = pivotRow<Field>(rows, order, i, c, m);
+        if (j == m) {
             continue;
         }
         if (i != j) {
             ++count_swaps;
-            std::swap(matrix_[i], matrix_[j]);
+            std::swap(order[i], order[j]);
         }
-        for (size_t k = i + 1; k < M; ++k) {
-            if (matrix_[i][i] == Field(0)) {
-                continue;
-            }
-            Field c = matrix_[k][i] / matrix_[i][i];
-            for (size_t h = 0; h < N; ++h) {
-                matrix_[k][h] -= c * matrix_[i][h];
+        size_t pivot = order[i];
+        Field pivot_inverse = inverse(rows[pivot][c]);
+        auto eliminate = [&rows, &order, &pivot_inverse, pivot, c, n](
+                             size_t lo, size_t hi) {
+            for (size_t k = lo; k < hi; ++k) {
+                const Field& value = rows[order[k]][c];
+                if (value != Field(0)) {
+                    subtractRow(rows, order[k], pivot, value * pivot_inverse,
+                                c, n);
+                }
             }
-        }
+        };
+        parallelRows(i + 1, m, (m - i - 1) * (n - c), eliminate);
+        ++i;
     }
     if (!to_revert) {
         return count_swaps;
     }
-    for (size_t i = M; i > 0; --i) {
-        for (size_t j = 0; j < i - 1; ++j) {
-            Field c = matrix_[j][i - 1] / matrix_[i - 1][i - 1];
-            for (size_t k = 0; k < 2 * M; ++k) {
-                matrix_[j][k] -= c * matrix_[i - 1][k];
+    for (size_t i = m; i > 0; --i) {
+        size_t pivot = order[i - 1];
+        Field pivot_inverse = inverse(rows[pivot][i - 1]);
+        auto eliminate = [&rows, &order, &pivot_inverse, pivot, i, n](
+                             size_t lo, size_t hi) {
+            for (size_t j = lo; j < hi; ++j) {
+                const Field& value = rows[order[j]][i - 1];
+                if (value != Field(0)) {
+                    subtractRow(rows, order[j], pivot, value * pivot_inverse,
+                                i - 1, n);
+                }
             }
-        }
+        };
+        parallelRows(0, i - 1, (i - 1) * (n - i + 1), eliminate);
     }
     return 0;
 }
 
+// Moves rows[order[i]] to rows[i] for the first n columns, one cycle of the
+// permutation at a time; order is left as the identity.
+template <typename Rows>
+void permuteRows(Rows&& rows, std::vector<size_t>& order, size_t n) {
+    for (size_t i = 0; i < order.size(); ++i) {
+        size_t current = i;
+        while (order[current] != i) {
+            size_t next = order[current];
+            for (size_t h = 0; h < n; ++h) {
+                std::swap(rows[current][h], rows[next][h]);
+            }
+            order[current] = current;
+            current = next;
+        }
+        order[current] = current;
+    }
+}
+
+// gaussEliminate with the row order applied to rows afterwards.
+template <typename Field, typename Rows>
+size_t gaussForwardAndReverse(Rows&& rows, size_t m, size_t n,
+                              bool to_revert) {
+    std::vector<size_t> order = identityOrder(m);
+    size_t count_swaps = gaussEliminate<Field>(rows, order, m, n, to_revert);
+    permuteRows(rows, order, n);
+    return count_swaps;
+}
+
+template <typename Field>
+struct StridedRows {
+    Field* data;
+    size_t stride;
+    Field* operator[](size_t row) const {
+        return data + row * stride;
+    }
+};
+
+// The first m rows and n columns of rows, as one row-major vector.
+template <typename Field, typename Rows>
+std::vector<Field> rowMajor(const Rows& rows, size_t m, size_t n) {
+    std::vector<Field> result;
+    result.reserve(m * n);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            result.push_back(rows[i][j]);
+        }
+    }
+    return result;
+}
+
+// A Rational matrix as row-major integers; see clearDenominators.
+template <typename Rows>
+std::vector<BigInteger> integerRows(const Rows& rows, size_t m, size_t n,
+                                    std::vector<BigInteger>& scales) {
+    return clearDenominators(rowMajor<Rational>(rows, m, n), m, n, scales);
+}
+
+// det, rank and invert shared by Matrix and DynamicMatrix; rows is any
+// row-indexable matrix and is only read. Rational matrices are eliminated
+// fraction-free (Bareiss) on integer copies of their rows, other fields by
+// gaussEliminate on a row-major scratch copy.
+template <typename Field, typename Rows>
+Field detOf(const Rows& rows, size_t n) {
+    if constexpr (std::is_same_v<Field, Rational>) {
+        std::vector<BigInteger> scales;
+        std::vector<BigInteger> integers = integerRows(rows, n, n, scales);
+        BareissResult result = bareissEliminate(integers, n, n, false);
+        if (result.rank < n) {
+            return Field(0);
+        }
+        if (n == 0) {
+            return Field(1);
+        }
+        BigInteger denominator = 1;
+        for (const BigInteger& scale : scales) {
+            denominator *= scale;
+        }
+        Field ans = Field(integers[result.order.back() * n + n - 1]) /
+                    Field(denominator);
+        return result.negated ? -ans : ans;
+    } else {
+        std::vector<Field> copy = rowMajor<Field>(rows, n, n);
+        StridedRows<Field> work{copy.data(), n};
+        std::vector<size_t> order = identityOrder(n);
+        size_t sign = gaussEliminate<Field>(work, order, n, n, false);
+        Field ans(1);
+        if (sign % 2 == 1) {
+            ans *= Field(-1);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            ans *= work[order[i]][i];
+        }
+        return ans;
+    }
+}
+
+template <typename Field, typename Rows>
+size_t rankOf(const Rows& rows, size_t m, size_t n) {
+    if constexpr (std::is_same_v<Field, Rational>) {
+        std::vector<BigInteger> scales;
+        std::vector<BigInteger> integers = integerRows(rows, m, n, scales);
+        return bareissEliminate(integers, m, n, false).rank;
+    } else {
+        std::vector<Field> copy = rowMajor<Field>(rows, m, n);
+        StridedRows<Field> work{copy.data(), n};
+        std::vector<size_t> order = identityOrder(m);
+        gaussEliminate<Field>(work, order, m, n, false);
+        size_t i = 0, j = 0;
+        while ((i < m) && (j < n)) {
+            if (work[order[i]][j] != Field(0)) {
+                ++i;
+            }
+            ++j;
+        }
+        return i;
+    }
+}
+
+// Writes the inverse of the n x n matrix rows to result, which may be rows
+// itself: the input is fully copied first.
+template <typename Field, typename Rows, typename Result>
+void invertInto(const Rows& rows, size_t n, Result&& result) {
+    if constexpr (std::is_same_v<Field, Rational>) {
+        // [S A | I] reduces to [d I | d (S A)^-1] for row scales S, and
+        // A^-1 = (S A)^-1 S.
+        std::vector<BigInteger> scales;
+        std::vector<BigInteger> integers = integerRows(rows, n, n, scales);
+        std::vector<BigInteger> augmented(2 * n * n, 0);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                augmented[i * 2 * n + j] = integers[i * n + j];
+            }
+            augmented[i * 2 * n + n + i] = 1;
+        }
+        std::vector<size_t> order =
+            bareissEliminate(augmented, n, 2 * n, true).order;
+        for (size_t i = 0; i < n; ++i) {
+            const BigInteger* row = augmented.data() + order[i] * 2 * n;
+            Field diagonal(row[i]);
+            for (size_t j = 0; j < n; ++j) {
+                result[i][j] = Field(row[n + j] * scales[j]) / diagonal;
+            }
+        }
+    } else {
+        std::vector<Field> copy(2 * n * n, Field(0));
+        StridedRows<Field> work{copy.data(), 2 * n};
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                work[i][j] = rows[i][j];
+            }
+            work[i][n + i] = Field(1);
+        }
+        std::vector<size_t> order = identityOrder(n);
+        gaussEliminate<Field>(work, order, n, 2 * n, true);
+        std::vector<Field> diagonal(n);
+        for (size_t i = 0; i < n; ++i) {
+            diagonal[i] = work[order[i]][i];
+        }
+        batchInverse(diagonal);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                result[i][j] = work[order[i]][j + n] * diagonal[i];
+            }
+        }
+    }
+}
+
+template <size_t M, size_t N, typename Field>
+size_t Matrix<M, N, Field>::gaussForwardAndReverse(bool to_revert) {
+    return ::gaussForwardAndReverse<Field>(matrix_, M, N, to_revert);
+}
+
 template <size_t M, size_t N, typename Field>
 Matrix<M, N, Field>& Matrix<M, N, Field>::sumSub(
     bool plus, const Matrix<M, N, Field>& other) {
+    if constexpr (SIMD_FIELD<Field>) {
+        static_assert(sizeof(matrix_) == M * N * sizeof(Field));
+        simdKernels<Field>().axpy(matrix_[0].data(), other.matrix_[0].data(),
+                                  Field(plus ? 1 : -1), M * N);
+        return *this;
+    }
     for (size_t i = 0; i < M; ++i) {
         for (size_t j = 0; j < N; ++j) {
             if (plus) {
@@ -255,6 +818,10 @@ Matrix<M, N, Field>& Matrix<M, N, Field>::operator-=(
 
 template <size_t M, size_t N, typename Field>
 Matrix<M, N, Field>& Matrix<M, N, Field>::operator*=(const Field& other) {
+    if constexpr (SIMD_FIELD<Field>) {
+        simdKernels<Field>().scale(matrix_[0].data(), other, M * N);
+        return *this;
+    }
     for (size_t i = 0; i < M; ++i) {
         for (size_t j = 0; j < N; ++j) {
             matrix_[i][j] *= other;
@@ -263,13 +830,6 @@ Matrix<M, N, Field>& Matrix<M, N, Field>::operator*=(const Field& other) {
     return *this;
 }
 
-template <size_t M, size_t N, typename Field>
-Matrix<M, N, Field> operator*(const Field& a, const Matrix<M, N, Field>& b) {
-    Matrix<M, N, Field> copy = b;
-    copy *= a;
-    return copy;
-}
-
 template <size_t M, size_t N, typename Field>
 Matrix<M, N, Field>& Matrix<M, N, Field>::operator*=(
     const Matrix<N, N, Field>& other) {
@@ -277,49 +837,521 @@ Matrix<M, N, Field>& Matrix<M, N, Field>::operator*=(
     return *this = *this * other;
 }
 
-template <size_t M, size_t N, size_t K, typename Field>
-Matrix<M, K, Field> operator*(const Matrix<M, N, Field>& a,
-                              const Matrix<N, K, Field>& b) {
-    Matrix<M, K, Field> copy;
-    for (size_t i = 0; i < M; ++i) {
-        for (size_t j = 0; j < K; ++j) {
-            for (size_t k = 0; k < N; ++k) {
-                copy[i][j] += a[i][k] * b[k][j];
+inline size_t& strassenCutoff() {
+    static size_t cutoff = 128;
+    return cutoff;
+}
+
+template <typename Field>
+std::vector<Field> strassenBlock(const std::vector<Field>& source, size_t n,
+                                 size_t row, size_t column) {
+    size_t half = n / 2;
+    std::vector<Field> block(half * half);
+    for (size_t i = 0; i < half; ++i) {
+        for (size_t j = 0; j < half; ++j) {
+            block[i * half + j] = source[(row + i) * n + column + j];
+        }
+    }
+    return block;
+}
+
+template <typename Field>
+std::vector<Field> strassenSum(bool plus, std::vector<Field> a,
+                               const std::vector<Field>& b) {
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (plus) {
+            a[i] += b[i];
+        } else {
+            a[i] -= b[i];
+        }
+    }
+    return a;
+}
+
+// Strassen-Winograd recursion on n x n row-major blocks: 7 half-size
+// products and 15 additions per level; n must be cutoff * 2^k.
+template <typename Field>
+std::vector<Field> strassenWinograd(const std::vector<Field>& a,
+                                    const std::vector<Field>& b, size_t n) {
+    if (n <= strassenCutoff() || n % 2 != 0) {
+        std::vector<Field> c(n * n, Field(0));
+        StridedRows<const Field> a_rows{a.data(), n};
+        StridedRows<const Field> b_rows{b.data(), n};
+        StridedRows<Field> c_rows{c.data(), n};
+        multiplyAccumulate<Field>(a_rows, b_rows, c_rows, n, n, n);
+        return c;
+    }
+    size_t half = n / 2;
+    std::vector<Field> a11 = strassenBlock(a, n, 0, 0);
+    std::vector<Field> a12 = strassenBlock(a, n, 0, half);
+    std::vector<Field> a21 = strassenBlock(a, n, half, 0);
+    std::vector<Field> a22 = strassenBlock(a, n, half, half);
+    std::vector<Field> b11 = strassenBlock(b, n, 0, 0);
+    std::vector<Field> b12 = strassenBlock(b, n, 0, half);
+    std::vector<Field> b21 = strassenBlock(b, n, half, 0);
+    std::vector<Field> b22 = strassenBlock(b, n, half, half);
+    std::vector<Field> s1 = strassenSum(true, a21, a22);
+    std::vector<Field> s2 = strassenSum(false, s1, a11);
+    std::vector<Field> s3 = strassenSum(false, a11, a21);
+    std::vector<Field> s4 = strassenSum(false, a12, s2);
+    std::vector<Field> t1 = strassenSum(false, b12, b11);
+    std::vector<Field> t2 = strassenSum(false, b22, t1);
+    std::vector<Field> t3 = strassenSum(false, b22, b12);
+    std::vector<Field> t4 = strassenSum(false, t2, b21);
+    std::vector<Field> m1 = strassenWinograd(a11, b11, half);
+    std::vector<Field> m2 = strassenWinograd(a12, b21, half);
+    std::vector<Field> m3 = strassenWinograd(s4, b22, half);
+    std::vector<Field> m4 = strassenWinograd(a22, t4, half);
+    std::vector<Field> m5 = strassenWinograd(s1, t1, half);
+    std::vector<Field> m6 = strassenWinograd(s2, t2, half);
+    std::vector<Field> m7 = strassenWinograd(s3, t3, half);
+    std::vector<Field> u2 = strassenSum(true, m1, m6);
+    std::vector<Field> u3 = strassenSum(true, u2, m7);
+    std::vector<Field> u4 = strassenSum(true, u2, m5);
+    std::vector<Field> c11 = strassenSum(true, m1, m2);
+    std::vector<Field> c12 = strassenSum(true, u4, m3);
+    std::vector<Field> c21 = strassenSum(false, u3, m4);
+    std::vector<Field> c22 = strassenSum(true, u3, m5);
+    std::vector<Field> c(n * n);
+    for (size_t i = 0; i < half; ++i) {
+        for (size_t j = 0; j < half; ++j) {
+            c[i * n + j] = c11[i * half + j];
+            c[i * n + half + j] = c12[i * half + j];
+            c[(half + i) * n + j] = c21[i * half + j];
+            c[(half + i) * n + half + j] = c22[i * half + j];
+        }
+    }
+    return c;
+}
+
+// Pads the row-indexable n x n operands to cutoff * 2^k for
+// strassenWinograd and writes the product into c.
+template <typename Field, typename A, typename B, typename C>
+void strassenMultiply(const A& a, const B& b, C&& c, size_t n) {
+    size_t levels = 0;
+    size_t base = n;
+    while (base > std::max<size_t>(strassenCutoff(), 1)) {
+        base = (base + 1) / 2;
+        ++levels;
+    }
+    size_t padded = base << levels;
+    std::vector<Field> a_padded(padded * padded, Field(0));
+    std::vector<Field> b_padded(padded * padded, Field(0));
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            a_padded[i * padded + j] = a[i][j];
+            b_padded[i * padded + j] = b[i][j];
+        }
+    }
+    std::vector<Field> c_padded = strassenWinograd(a_padded, b_padded, padded);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            c[i][j] = c_padded[i * padded + j];
+        }
+    }
+}
+
+template <typename Field>
+bool useStrassen(size_t rows, size_t inner, size_t columns) {
+    return rows == inner && inner == columns &&
+           !std::is_floating_point_v<Field> && rows > strassenCutoff();
+}
+
+// c = a * b for row-indexable operands; c must not alias a or b.
+template <typename Field, typename A, typename B, typename C>
+void multiplyInto(const A& a, const B& b, C&& c, size_t rows, size_t inner,
+                  size_t columns) {
+    if (useStrassen<Field>(rows, inner, columns)) {
+        strassenMultiply<Field>(a, b, c, rows);
+        return;
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < columns; ++j) {
+            c[i][j] = Field(0);
+        }
+    }
+    multiplyAccumulate<Field>(a, b, c, rows, inner, columns);
+}
+
+template <size_t M, size_t N, typename Field>
+class MatrixReference {
+  public:
+    static constexpr size_t ROWS = M;
+    static constexpr size_t COLUMNS = N;
+    static constexpr bool ELEMENTWISE = true;
+    static constexpr bool CELLWISE = true;
+    using FieldType = Field;
+    explicit MatrixReference(const Matrix<M, N, Field>& matrix)
+        : matrix_(matrix) {}
+    const Field& at(size_t i, size_t j) const {
+        return matrix_[i][j];
+    }
+    const Matrix<M, N, Field>& matrix() const {
+        return matrix_;
+    }
+    bool aliases(const void* destination) const {
+        return &matrix_ == destination;
+    }
+
+  private:
+    const Matrix<M, N, Field>& matrix_;
+};
+
+// A temporary operand, moved into the expression so that the expression
+// can outlive the full-expression that created it.
+template <size_t M, size_t N, typename Field>
+class MatrixValue {
+  public:
+    static constexpr size_t ROWS = M;
+    static constexpr size_t COLUMNS = N;
+    static constexpr bool ELEMENTWISE = true;
+    static constexpr bool CELLWISE = true;
+    using FieldType = Field;
+    explicit MatrixValue(Matrix<M, N, Field>&& matrix)
+        : matrix_(std::move(matrix)) {}
+    const Field& at(size_t i, size_t j) const {
+        return matrix_[i][j];
+    }
+    const Matrix<M, N, Field>& matrix() const {
+        return matrix_;
+    }
+    bool aliases(const void*) const {
+        return false;
+    }
+
+  private:
+    Matrix<M, N, Field> matrix_;
+};
+
+template <typename T>
+concept MatrixOperand = isMatrix<std::remove_cvref_t<T>> ||
+                        MatrixExpressionType<std::remove_cvref_t<T>>;
+
+// Matrices are referred to if they are lvalues and held by value if they
+// are rvalues; expressions are copied or moved.
+template <MatrixOperand T>
+auto asExpression(T&& operand) {
+    using Operand = std::remove_cvref_t<T>;
+    if constexpr (!isMatrix<Operand>) {
+        return Operand(std::forward<T>(operand));
+    } else if constexpr (std::is_lvalue_reference_v<T>) {
+        return MatrixReference<Operand::ROWS, Operand::COLUMNS,
+                               typename Operand::FieldType>(operand);
+    } else {
+        return MatrixValue<Operand::ROWS, Operand::COLUMNS,
+                           typename Operand::FieldType>(std::move(operand));
+    }
+}
+
+template <typename T>
+using ExpressionOf = decltype(asExpression(std::declval<T>()));
+
+template <typename Expression>
+using ResultOf = Matrix<Expression::ROWS, Expression::COLUMNS,
+                        typename Expression::FieldType>;
+
+// The operand itself if it is a plain matrix, otherwise its value.
+template <typename Expression>
+decltype(auto) evaluated(const Expression& expression) {
+    if constexpr (requires { expression.matrix(); }) {
+        return expression.matrix();
+    } else {
+        return ResultOf<Expression>(expression);
+    }
+}
+
+// Like evaluated, but transposed views are multiplied in place.
+template <typename Expression>
+decltype(auto) multiplicand(const Expression& expression) {
+    if constexpr (requires { expression.source(); }) {
+        return expression;
+    } else {
+        return evaluated(expression);
+    }
+}
+
+template <typename Expression, typename Destination>
+void assignExpression(const Expression& expression, Destination& destination) {
+    if constexpr (Expression::ELEMENTWISE) {
+        for (size_t i = 0; i < Expression::ROWS; ++i) {
+            for (size_t j = 0; j < Expression::COLUMNS; ++j) {
+                destination[i][j] = expression.at(i, j);
             }
         }
+    } else {
+        expression.assignTo(destination);
     }
-    return copy;
 }
 
+template <typename Expression, typename Destination>
+void addExpression(const Expression& expression, Destination& destination,
+                   bool plus) {
+    if constexpr (Expression::ELEMENTWISE) {
+        for (size_t i = 0; i < Expression::ROWS; ++i) {
+            for (size_t j = 0; j < Expression::COLUMNS; ++j) {
+                if (plus) {
+                    destination[i][j] += expression.at(i, j);
+                } else {
+                    destination[i][j] -= expression.at(i, j);
+                }
+            }
+        }
+    } else {
+        expression.addTo(destination, plus);
+    }
+}
+
+// Convenience members so that e.g. (a * b).det() reads like on a Matrix.
+// Row and column access evaluate the whole expression on every call.
+template <typename Derived>
+class MatrixExpression {
+  public:
+    auto eval() const {
+        return ResultOf<Derived>(static_cast<const Derived&>(*this));
+    }
+    auto operator[](size_t index) const {
+        return eval().getRow(index);
+    }
+    auto getRow(size_t row) const {
+        return eval().getRow(row);
+    }
+    auto getColumn(size_t column) const {
+        return eval().getColumn(column);
+    }
+    auto det() const {
+        return eval().det();
+    }
+    size_t rank() const {
+        return eval().rank();
+    }
+    auto trace() const {
+        return eval().trace();
+    }
+    auto transposed() const {
+        return eval().transposed();
+    }
+    auto inverted() const {
+        return eval().inverted();
+    }
+};
+
+// a^T without a copy: row i is column i of a, and as the right operand of
+// a product the kernel takes dot products of rows of a instead.
 template <size_t M, size_t N, typename Field>
-Matrix<M, N, Field> operator+(const Matrix<M, N, Field>& a,
-                              const Matrix<M, N, Field>& b) {
-    Matrix<M, N, Field> copy = a;
-    copy += b;
-    return copy;
+class TransposedView
+    : public MatrixExpression<TransposedView<M, N, Field>> {
+  public:
+    static constexpr size_t ROWS = N;
+    static constexpr size_t COLUMNS = M;
+    static constexpr bool ELEMENTWISE = true;
+    static constexpr bool CELLWISE = false;
+    using FieldType = Field;
+    explicit TransposedView(const Matrix<M, N, Field>& matrix)
+        : matrix_(matrix) {}
+    const Field& at(size_t i, size_t j) const {
+        return matrix_[j][i];
+    }
+    StridedSpan<const Field> operator[](size_t index) const {
+        return matrix_.column(index);
+    }
+    const Matrix<M, N, Field>& source() const {
+        return matrix_;
+    }
+    bool aliases(const void* destination) const {
+        return &matrix_ == destination;
+    }
+
+  private:
+    const Matrix<M, N, Field>& matrix_;
+};
+
+template <typename Left, typename Right, bool PLUS>
+class SumExpression
+    : public MatrixExpression<SumExpression<Left, Right, PLUS>> {
+  public:
+    static constexpr size_t ROWS = Left::ROWS;
+    static constexpr size_t COLUMNS = Left::COLUMNS;
+    static constexpr bool ELEMENTWISE =
+        Left::ELEMENTWISE && Right::ELEMENTWISE;
+    static constexpr bool CELLWISE = Left::CELLWISE && Right::CELLWISE;
+    using FieldType = typename Left::FieldType;
+    SumExpression(Left left, Right right)
+        : left_(std::move(left)), right_(std::move(right)) {}
+    FieldType at(size_t i, size_t j) const {
+        return PLUS ? left_.at(i, j) + right_.at(i, j)
+                    : left_.at(i, j) - right_.at(i, j);
+    }
+    template <typename Destination>
+    void assignTo(Destination& destination) const {
+        assignExpression(left_, destination);
+        addExpression(right_, destination, PLUS);
+    }
+    template <typename Destination>
+    void addTo(Destination& destination, bool plus) const {
+        addExpression(left_, destination, plus);
+        addExpression(right_, destination, plus == PLUS);
+    }
+    bool aliases(const void* destination) const {
+        return left_.aliases(destination) || right_.aliases(destination);
+    }
+
+  private:
+    Left left_;
+    Right right_;
+};
+
+template <typename Operand>
+class ScaledExpression : public MatrixExpression<ScaledExpression<Operand>> {
+  public:
+    static constexpr size_t ROWS = Operand::ROWS;
+    static constexpr size_t COLUMNS = Operand::COLUMNS;
+    static constexpr bool ELEMENTWISE = Operand::ELEMENTWISE;
+    static constexpr bool CELLWISE = Operand::CELLWISE;
+    using FieldType = typename Operand::FieldType;
+    ScaledExpression(const FieldType& scale, Operand operand)
+        : scale_(scale), operand_(std::move(operand)) {}
+    FieldType at(size_t i, size_t j) const {
+        return scale_ * operand_.at(i, j);
+    }
+    template <typename Destination>
+    void assignTo(Destination& destination) const {
+        assignExpression(operand_, destination);
+        destination *= scale_;
+    }
+    template <typename Destination>
+    void addTo(Destination& destination, bool plus) const {
+        ResultOf<ScaledExpression> value(*this);
+        addExpression(MatrixReference(value), destination, plus);
+    }
+    bool aliases(const void* destination) const {
+        return operand_.aliases(destination);
+    }
+
+  private:
+    FieldType scale_;
+    Operand operand_;
+};
+
+template <typename Left, typename Right>
+class ProductExpression
+    : public MatrixExpression<ProductExpression<Left, Right>> {
+  public:
+    static constexpr size_t ROWS = Left::ROWS;
+    static constexpr size_t COLUMNS = Right::COLUMNS;
+    static constexpr bool ELEMENTWISE = false;
+    static constexpr bool CELLWISE = false;
+    using FieldType = typename Left::FieldType;
+    ProductExpression(Left left, Right right)
+        : left_(std::move(left)), right_(std::move(right)) {}
+    template <typename Destination>
+    void assignTo(Destination& destination) const {
+        multiplyInto<FieldType>(multiplicand(left_), multiplicand(right_),
+                                destination, ROWS, INNER_, COLUMNS);
+    }
+    template <typename Destination>
+    void addTo(Destination& destination, bool plus) const {
+        if (plus && !useStrassen<FieldType>(ROWS, INNER_, COLUMNS)) {
+            multiplyAccumulate<FieldType>(multiplicand(left_),
+                                          multiplicand(right_), destination,
+                                          ROWS, INNER_, COLUMNS);
+            return;
+        }
+        ResultOf<ProductExpression> value(*this);
+        addExpression(MatrixReference(value), destination, plus);
+    }
+    bool aliases(const void* destination) const {
+        return left_.aliases(destination) || right_.aliases(destination);
+    }
+
+  private:
+    static constexpr size_t INNER_ = Left::COLUMNS;
+    Left left_;
+    Right right_;
+};
+
+template <size_t M, size_t N, typename Field>
+template <MatrixExpressionOf<M, N, Field> Expression>
+Matrix<M, N, Field>::Matrix(const Expression& expression) {
+    assignExpression(expression, *this);
 }
 
-template <size_t N, size_t M, typename Field>
-Matrix<M, N, Field> operator-(const Matrix<M, N, Field>& a,
-                              const Matrix<M, N, Field>& b) {
-    Matrix<M, N, Field> copy = a;
-    copy -= b;
-    return copy;
+// Cellwise expressions read each cell before writing it, so only the
+// others need a temporary when they refer to the destination.
+template <size_t M, size_t N, typename Field>
+template <MatrixExpressionOf<M, N, Field> Expression>
+Matrix<M, N, Field>& Matrix<M, N, Field>::operator=(
+    const Expression& expression) {
+    if (!Expression::CELLWISE && expression.aliases(this)) {
+        return *this = Matrix(expression);
+    }
+    assignExpression(expression, *this);
+    return *this;
 }
 
 template <size_t M, size_t N, typename Field>
-Field Matrix<M, N, Field>::det() const {
-    static_assert(M == N, "Det: matrix_ is not a square");
-    Matrix<M, N, Field> copy = *this;
-    size_t sign = copy.gaussForwardAndReverse(false);
-    Field ans(1);
-    if (sign % 2 == 1) {
-        ans *= Field(-1);
+template <MatrixExpressionOf<M, N, Field> Expression>
+Matrix<M, N, Field>& Matrix<M, N, Field>::operator+=(
+    const Expression& expression) {
+    if (!Expression::CELLWISE && expression.aliases(this)) {
+        return *this += Matrix(expression);
     }
-    for (size_t i = 0; i < M; ++i) {
-        ans *= copy[i][i];
+    addExpression(expression, *this, true);
+    return *this;
+}
+
+template <size_t M, size_t N, typename Field>
+template <MatrixExpressionOf<M, N, Field> Expression>
+Matrix<M, N, Field>& Matrix<M, N, Field>::operator-=(
+    const Expression& expression) {
+    if (!Expression::CELLWISE && expression.aliases(this)) {
+        return *this -= Matrix(expression);
     }
-    return ans;
+    addExpression(expression, *this, false);
+    return *this;
+}
+
+template <MatrixOperand L, MatrixOperand R>
+auto operator+(L&& a, R&& b) {
+    static_assert(ExpressionOf<L>::ROWS == ExpressionOf<R>::ROWS &&
+                      ExpressionOf<L>::COLUMNS == ExpressionOf<R>::COLUMNS,
+                  "Addition: dimensions differ");
+    return SumExpression<ExpressionOf<L>, ExpressionOf<R>, true>(
+        asExpression(std::forward<L>(a)), asExpression(std::forward<R>(b)));
+}
+
+template <MatrixOperand L, MatrixOperand R>
+auto operator-(L&& a, R&& b) {
+    static_assert(ExpressionOf<L>::ROWS == ExpressionOf<R>::ROWS &&
+                      ExpressionOf<L>::COLUMNS == ExpressionOf<R>::COLUMNS,
+                  "Subtraction: dimensions differ");
+    return SumExpression<ExpressionOf<L>, ExpressionOf<R>, false>(
+        asExpression(std::forward<L>(a)), asExpression(std::forward<R>(b)));
+}
+
+template <MatrixOperand R>
+auto operator*(const typename ExpressionOf<R>::FieldType& a, R&& b) {
+    return ScaledExpression<ExpressionOf<R>>(a,
+                                             asExpression(std::forward<R>(b)));
+}
+
+template <MatrixOperand L, MatrixOperand R>
+auto operator*(L&& a, R&& b) {
+    static_assert(ExpressionOf<L>::COLUMNS == ExpressionOf<R>::ROWS,
+                  "Multiplication: dimensions differ");
+    return ProductExpression<ExpressionOf<L>, ExpressionOf<R>>(
+        asExpression(std::forward<L>(a)), asExpression(std::forward<R>(b)));
+}
+
+template <MatrixOperand L, MatrixOperand R>
+    requires(!isMatrix<L> || !isMatrix<R>)
+bool operator==(const L& a, const R& b) {
+    return evaluated(asExpression(a)) == evaluated(asExpression(b));
+}
+
+template <size_t M, size_t N, typename Field>
+Field Matrix<M, N, Field>::det() const {
+    static_assert(M == N, "Det: matrix_ is not a square");
+    return detOf<Field>(matrix_, N);
 }
 
 template <size_t M, size_t N, typename Field>
@@ -333,18 +1365,50 @@ Matrix<N, M, Field> Matrix<M, N, Field>::transposed() const {
     return copy;
 }
 
+template <size_t M, size_t N, typename Field>
+TransposedView<M, N, Field> Matrix<M, N, Field>::transposedView() const& {
+    return TransposedView<M, N, Field>(*this);
+}
+
+template <size_t M, size_t N, typename Field>
+std::span<Field, N> Matrix<M, N, Field>::row(size_t index) {
+    return matrix_[index];
+}
+
+template <size_t M, size_t N, typename Field>
+std::span<const Field, N> Matrix<M, N, Field>::row(size_t index) const {
+    return matrix_[index];
+}
+
+template <size_t M, size_t N, typename Field>
+StridedSpan<Field> Matrix<M, N, Field>::column(size_t index) {
+    return {matrix_[0].data() + index, N, M};
+}
+
+template <size_t M, size_t N, typename Field>
+StridedSpan<const Field> Matrix<M, N, Field>::column(size_t index) const {
+    return {matrix_[0].data() + index, N, M};
+}
+
+// Rows of matrix_ are adjacent std::arrays, so one stride spans them.
+template <size_t M, size_t N, typename Field>
+BlockView<Field> Matrix<M, N, Field>::block(size_t row, size_t column,
+                                            size_t rows, size_t columns) {
+    static_assert(sizeof(matrix_) == M * N * sizeof(Field));
+    return {matrix_[0].data() + row * N + column, N, rows, columns};
+}
+
+template <size_t M, size_t N, typename Field>
+BlockView<const Field> Matrix<M, N, Field>::block(size_t row, size_t column,
+                                                  size_t rows,
+                                                  size_t columns) const {
+    static_assert(sizeof(matrix_) == M * N * sizeof(Field));
+    return {matrix_[0].data() + row * N + column, N, rows, columns};
+}
+
 template <size_t M, size_t N, typename Field>
 size_t Matrix<M, N, Field>::rank() const {
-    Matrix copy(*this);
-    copy.gaussForwardAndReverse(false);
-    size_t i = 0, j = 0;
-    while ((i < M) && (j < N)) {
-        if (copy[i][j] != Field(0)) {
-            ++i;
-        }
-        ++j;
-    }
-    return i;
+    return rankOf<Field>(matrix_, M, N);
 }
 
 template <size_t M, size_t N, typename Field>
@@ -357,19 +1421,7 @@ Matrix<M, N, Field> Matrix<M, N, Field>::inverted() const {
 template <size_t M, size_t N, typename Field>
 void Matrix<M, N, Field>::invert() {
     static_assert(M == N, "Invert: matrix_ is not a square");
-    Matrix<M, 2 * M, Field> copy;
-    for (size_t i = 0; i < M; ++i) {
-        for (size_t j = 0; j < M; ++j) {
-            copy[i][j] = matrix_[i][j];
-        }
-        copy[i][N + i] = Field(1);
-    }
-    copy.gaussForwardAndReverse(true);
-    for (size_t i = 0; i < M; ++i) {
-        for (size_t j = 0; j < M; ++j) {
-            matrix_[i][j] = copy[i][j + M] / copy[i][i];
-        }
-    }
+    invertInto<Field>(matrix_, N, matrix_);
 }
 
 template <size_t M, size_t N, typename Field>
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <bit>
+#include "dynamic_matrix.h"
+
+// z[k] += x[k] * y[k] for k < n, or -= if subtract: the one lane-wise step
+// every MatrixBatch operation is built from.
+template <typename Field>
+void multiplyLanes(Field* z, const Field* x, const Field* y, size_t n,
+                   bool subtract) {
+    if constexpr (SIMD_FIELD<Field>) {
+        const SimdKernels<Field>& kernels = simdKernels<Field>();
+        (subtract ? kernels.multiplySubtract : kernels.multiplyAdd)(z, x, y,
+                                                                    n);
+    } else if (subtract) {
+        for (size_t k = 0; k < n; ++k) {
+            z[k] -= x[k] * y[k];
+        }
+    } else {
+        for (size_t k = 0; k < n; ++k) {
+            z[k] += x[k] * y[k];
+        }
+    }
+}
+
+// size() independent M x N matrices in structure-of-arrays layout: entry
+// (i, j) of all of them is the contiguous run lanes(i, j), so an operation
+// is a fixed sequence of lane-wise steps with one SIMD lane per matrix and
+// no branching on the values. Meant for many small matrices, e.g. 3 x 3 and
+// 4 x 4 transforms, where per-matrix calls are dominated by overhead.
+// Work is done SIMD_BLOCK matrices at a time to stay in cache. det and
+// inverted are lane-wise up to MAX_MINOR_SIZE; larger matrices fall back to
+// per-matrix elimination, since the minor table grows as 4^N.
+const size_t MAX_MINOR_SIZE = 4;
+
+template <size_t M, size_t N, typename Field>
+class MatrixBatch {
+  public:
+    explicit MatrixBatch(size_t count);
+    size_t size() const;
+    Matrix<M, N, Field> get(size_t index) const;
+    void set(size_t index, const Matrix<M, N, Field>& matrix);
+    const Field* lanes(size_t i, size_t j) const;
+    Field* lanes(size_t i, size_t j);
+    std::vector<Field> det() const;
+    // Every matrix must be invertible; floating-point singular ones come
+    // out non-finite.
+    MatrixBatch inverted() const;
+
+  private:
+    // Runs start on cache-line boundaries.
+    static constexpr size_t PADDING_ =
+        std::max<size_t>(1, MATRIX_ALIGNMENT / sizeof(Field));
+    static constexpr size_t FULL_ = (size_t(1) << N) - 1;
+    void minors(size_t from, size_t length, size_t holes,
+                std::vector<std::vector<Field>>& table) const;
+    size_t count_;
+    size_t stride_;
+    std::vector<Field, AlignedAllocator<Field>> data_;
+};
+
+template <size_t M, size_t N, typename Field>
+MatrixBatch<M, N, Field>::MatrixBatch(size_t count)
+    : count_(count),
+      stride_((count + PADDING_ - 1) / PADDING_ * PADDING_),
+      data_(M * N * stride_, Field(0)) {}
+
+template <size_t M, size_t N, typename Field>
+size_t MatrixBatch<M, N, Field>::size() const {
+    return count_;
+}
+
+template <size_t M, size_t N, typename Field>
+Matrix<M, N, Field> MatrixBatch<M, N, Field>::get(size_t index) const {
+    assert(index < count_);
+    Matrix<M, N, Field> result;
+    for (size_t i = 0; i < M; ++i) {
+        for (size_t j = 0; j < N; ++j) {
+            result[i][j] = lanes(i, j)[index];
+        }
+    }
+    return result;
+}
+
+template <size_t M, size_t N, typename Field>
+void MatrixBatch<M, N, Field>::set(size_t index,
+                                   const Matrix<M, N, Field>& matrix) {
+    assert(index < count_);
+    for (size_t i = 0; i < M; ++i) {
+        for (size_t j = 0; j < N; ++j) {
+            lanes(i, j)[index] = matrix[i][j];
+        }
+    }
+}
+
+template <size_t M, size_t N, typename Field>
+const Field* MatrixBatch<M, N, Field>::lanes(size_t i, size_t j) const {
+    return data_.data() + (i * N + j) * stride_;
+}
+
+template <size_t M, size_t N, typename Field>
+Field* MatrixBatch<M, N, Field>::lanes(size_t i, size_t j) {
+    return data_.data() + (i * N + j) * stride_;
+}
+
+// Fills table[rows << N | columns] with the minors on those row and column
+// sets for matrices [from, from + length), expanding each along its first
+// row. That row is dropped next, so only row sets that are a suffix of
+// 0..N-1 with at most holes rows missing are needed: suffixes alone give
+// the determinant, one hole gives every cofactor. 15 minors for a 4 x 4
+// determinant and 43 for the inverse, all lane-wise.
+template <size_t M, size_t N, typename Field>
+void MatrixBatch<M, N, Field>::minors(
+    size_t from, size_t length, size_t holes,
+    std::vector<std::vector<Field>>& table) const {
+    static_assert(M == N && N <= MAX_MINOR_SIZE);
+    table[0].assign(length, Field(1));
+    for (int size = 1; size <= static_cast<int>(N); ++size) {
+        for (size_t rows = 1; rows <= FULL_; ++rows) {
+            size_t first = rows & (~rows + 1);
+            size_t suffix = FULL_ & ~(first - 1);
+            if (std::popcount(rows) != size ||
+                static_cast<size_t>(std::popcount(suffix ^ rows)) > holes) {
+                continue;
+            }
+            size_t row = std::countr_zero(rows);
+            for (size_t columns = 1; columns <= FULL_; ++columns) {
+                if (std::popcount(columns) != size) {
+                    continue;
+                }
+                std::vector<Field>& minor = table[rows << N | columns];
+                minor.assign(length, Field(0));
+                bool subtract = false;
+                for (size_t column = 0; column < N; ++column) {
+                    if ((columns >> column & 1) == 0) {
+                        continue;
+                    }
+                    size_t rest = (rows ^ first) << N |
+                                  (columns ^ (size_t(1) << column));
+                    multiplyLanes(minor.data(), lanes(row, column) + from,
+                                  table[rest].data(), length, subtract);
+                    subtract = !subtract;
+                }
+            }
+        }
+    }
+}
+
+template <size_t M, size_t N, typename Field>
+std::vector<Field> MatrixBatch<M, N, Field>::det() const {
+    std::vector<Field> result(count_);
+    if constexpr (N > MAX_MINOR_SIZE) {
+        for (size_t k = 0; k < count_; ++k) {
+            result[k] = get(k).det();
+        }
+    } else {
+        std::vector<std::vector<Field>> table(size_t(1) << 2 * N);
+        for (size_t from = 0; from < count_; from += SIMD_BLOCK) {
+            size_t length = std::min(SIMD_BLOCK, count_ - from);
+            minors(from, length, 0, table);
+            const std::vector<Field>& minor = table[FULL_ << N | FULL_];
+            std::copy(minor.begin(), minor.end(), result.begin() + from);
+        }
+    }
+    return result;
+}
+
+// The adjugate divided by the determinant, so no pivoting: rotations and
+// permutations with zeros on the diagonal take the same path as any other
+// matrix.
+template <size_t M, size_t N, typename Field>
+MatrixBatch<M, N, Field> MatrixBatch<M, N, Field>::inverted() const {
+    MatrixBatch result(count_);
+    if constexpr (N > MAX_MINOR_SIZE) {
+        for (size_t k = 0; k < count_; ++k) {
+            result.set(k, get(k).inverted());
+        }
+    } else {
+        std::vector<std::vector<Field>> table(size_t(1) << 2 * N);
+        std::vector<Field> reciprocal(SIMD_BLOCK);
+        for (size_t from = 0; from < count_; from += SIMD_BLOCK) {
+            size_t length = std::min(SIMD_BLOCK, count_ - from);
+            minors(from, length, 1, table);
+            const std::vector<Field>& det = table[FULL_ << N | FULL_];
+            for (size_t k = 0; k < length; ++k) {
+                reciprocal[k] = Field(1) / det[k];
+            }
+            for (size_t i = 0; i < N; ++i) {
+                for (size_t j = 0; j < N; ++j) {
+                    size_t cofactor = (FULL_ ^ (size_t(1) << i)) << N |
+                                      (FULL_ ^ (size_t(1) << j));
+                    multiplyLanes(result.lanes(j, i) + from,
+                                  table[cofactor].data(), reciprocal.data(),
+                                  length, (i + j) % 2 == 1);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+template <size_t M, size_t N, size_t K, typename Field>
+MatrixBatch<M, K, Field> operator*(const MatrixBatch<M, N, Field>& a,
+                                   const MatrixBatch<N, K, Field>& b) {
+    assert(a.size() == b.size());
+    MatrixBatch<M, K, Field> result(a.size());
+    for (size_t from = 0; from < a.size(); from += SIMD_BLOCK) {
+        size_t length = std::min(SIMD_BLOCK, a.size() - from);
+        for (size_t i = 0; i < M; ++i) {
+            for (size_t j = 0; j < K; ++j) {
+                for (size_t k = 0; k < N; ++k) {
+                    multiplyLanes(result.lanes(i, j) + from,
+                                  a.lanes(i, k) + from, b.lanes(k, j) + from,
+                                  length, false);
+                }
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,307 @@
+#include "charpoly.h"
+#include "dynamic_matrix.h"
+#include "matrix.h"
+#include "matrix_batch.h"
+#include "polynomial.h"
+#include "simd.h"
+#include "sparse_matrix.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+template <typename Function>
+double measure(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void rationalWorkload(size_t iterations) {
+    Rational total = 0;
+    for (size_t i = 1; i <= iterations; ++i) {
+        total += Rational(1) / Rational(static_cast<int>(i % 97 + 1));
+        BigInteger a = BigInteger("123456789012345678901234567890") *
+                       static_cast<long long>(i);
+        a /= BigInteger(static_cast<long long>(i % 1000 + 7));
+    }
+}
+
+void benchLimbPool() {
+    const size_t threads = 32;
+    const size_t iterations = 300;
+    for (bool enabled : {false, true}) {
+        setLimbPoolEnabled(enabled);
+        double time = measure([&]() {
+            std::vector<std::thread> workers;
+            for (size_t i = 0; i < threads; ++i) {
+                workers.emplace_back(rationalWorkload, iterations);
+            }
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+        });
+        std::cout << "limb pool " << (enabled ? "on " : "off") << ", "
+                  << threads << " threads: " << time << " ms" << std::endl;
+    }
+}
+
+template <size_t N, typename Field>
+void fillMatrix(Matrix<N, N, Field>& matrix) {
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = 0; j < N; ++j) {
+            matrix[i][j] = Field(static_cast<int>((i * 131 + j * 71) % 1000));
+        }
+    }
+}
+
+template <size_t N, typename Field>
+void naiveMultiply(const Matrix<N, N, Field>& a, const Matrix<N, N, Field>& b,
+                   Matrix<N, N, Field>& c) {
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = 0; j < N; ++j) {
+            for (size_t k = 0; k < N; ++k) {
+                c[i][j] += a[i][k] * b[k][j];
+            }
+        }
+    }
+}
+
+template <size_t N, typename Field>
+void benchMultiply(const char* name) {
+    auto a = std::make_unique<Matrix<N, N, Field>>();
+    auto b = std::make_unique<Matrix<N, N, Field>>();
+    auto c = std::make_unique<Matrix<N, N, Field>>();
+    fillMatrix(*a);
+    fillMatrix(*b);
+    double naive = measure([&]() { naiveMultiply(*a, *b, *c); });
+    double blocked = measure([&]() { *c = *a * *b; });
+    double operations = static_cast<double>(N) * N * N;
+    std::cout << "multiply " << name << " " << N << "x" << N
+              << ": naive " << operations / naive / 1e3 << " Mop/s, blocked "
+              << operations / blocked / 1e3 << " Mop/s" << std::endl;
+}
+
+template <typename Field>
+void benchMultiplySizes(const char* name) {
+    benchMultiply<64, Field>(name);
+    benchMultiply<128, Field>(name);
+    benchMultiply<256, Field>(name);
+    benchMultiply<512, Field>(name);
+    benchMultiply<1024, Field>(name);
+}
+
+template <size_t N, typename Field>
+void benchParallel(const char* name) {
+    auto a = std::make_unique<Matrix<N, N, Field>>();
+    fillMatrix(*a);
+    for (size_t i = 0; i < N; ++i) {
+        (*a)[i][i] += Field(static_cast<int>(i) + 1);
+    }
+    size_t threads = parallelThreads();
+    for (size_t count : {size_t(1), threads}) {
+        parallelThreads() = count;
+        auto c = std::make_unique<Matrix<N, N, Field>>();
+        double multiply = measure([&]() { *c = *a * *a; });
+        double invert = measure([&]() { *c = a->inverted(); });
+        std::cout << name << " " << N << "x" << N << ", " << count
+                  << " threads: multiply " << multiply << " ms, invert "
+                  << invert << " ms" << std::endl;
+    }
+    parallelThreads() = threads;
+}
+
+void benchSparse(size_t n) {
+    std::vector<SparseMatrix<998244353>::Entry> entries;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t k = 0; k < 5; ++k) {
+            entries.push_back({i, (i * (2 * k + 1) + k * k) % n,
+                               Residue<998244353>(static_cast<int>(i + k))});
+        }
+    }
+    SparseMatrix<998244353> a(n, n, entries);
+    std::vector<Residue<998244353>> b(n, Residue<998244353>(1));
+    bool solved = false;
+    double time = measure([&]() { solved = a.solve(b).has_value(); });
+    std::cout << "sparse solve " << n << "x" << n << ", " << a.nonZeros()
+              << " nonzeros: " << time << " ms" << (solved ? "" : " (singular)")
+              << std::endl;
+}
+
+// Rows of a unit upper triangular matrix with small entries, reversed so
+// that every elimination step has to pivot.
+template <size_t N>
+void benchRationalElimination() {
+    auto a = std::make_unique<Matrix<N, N, Rational>>();
+    for (size_t i = 0; i < N; ++i) {
+        (*a)[N - 1 - i][i] = Rational(1);
+        for (size_t j = i + 1; j < N; ++j) {
+            (*a)[N - 1 - i][j] = Rational(static_cast<int>((i * j) % 7) - 3);
+        }
+    }
+    Rational det;
+    size_t rank = 0;
+    double det_time = measure([&]() { det = a->det(); });
+    double rank_time = measure([&]() { rank = a->rank(); });
+    DynamicMatrix<Rational> dynamic(*a);
+    double gauss_time =
+        measure([&]() { dynamic.gaussForwardAndReverse(false); });
+    std::cout << "Rational " << N << "x" << N << " elimination: det " << det
+              << " in " << det_time << " ms, rank " << rank << " in "
+              << rank_time << " ms, gauss " << gauss_time << " ms"
+              << std::endl;
+}
+
+template <size_t N, typename Field>
+void benchSimd(const char* name) {
+    auto a = std::make_unique<Matrix<N, N, Field>>();
+    fillMatrix(*a);
+    for (size_t i = 0; i < N; ++i) {
+        (*a)[i][i] += Field(1000);
+    }
+    SimdLevel detected = detectSimdLevel();
+    for (SimdLevel level :
+         {SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        if (level > detected) {
+            continue;
+        }
+        simdLevel() = level;
+        auto c = std::make_unique<Matrix<N, N, Field>>();
+        double multiply = measure([&]() { *c = *a * *a; });
+        double invert = measure([&]() { *c = a->inverted(); });
+        std::cout << name << " " << N << "x" << N << ", SIMD level "
+                  << static_cast<int>(level) << ": multiply " << multiply
+                  << " ms, invert " << invert << " ms" << std::endl;
+    }
+    simdLevel() = detected;
+}
+
+void benchPolynomial(size_t n) {
+    using F = Residue<998244353>;
+    std::vector<F> coefficients(n);
+    std::vector<F> points(n);
+    for (size_t i = 0; i < n; ++i) {
+        coefficients[i] = F(static_cast<long long>(i * i % 1009 + 1));
+        points[i] = F(static_cast<long long>(3 * i + 1));
+    }
+    Polynomial<F> a(coefficients);
+    std::vector<F> naive(2 * n - 1, F(0));
+    double schoolbook = measure([&]() {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                naive[i + j] += coefficients[i] * coefficients[j];
+            }
+        }
+    });
+    Polynomial<F> square;
+    double fast = measure([&]() { square = a * a; });
+    std::vector<F> values;
+    double horner = measure([&]() {
+        for (const F& point : points) {
+            values.push_back(a(point));
+        }
+    });
+    double multipoint = measure([&]() { values = a.evaluate(points); });
+    std::cout << "polynomial degree " << n - 1 << ": multiply schoolbook "
+              << schoolbook << " ms, NTT " << fast << " ms"
+              << (square.coefficients() == naive ? "" : " (mismatch)")
+              << "; evaluate at " << n << " points Horner " << horner
+              << " ms, subproduct tree " << multipoint << " ms" << std::endl;
+}
+
+// The old route: det(t I - a) at N + 1 points, before interpolation.
+template <size_t N>
+void benchCharpoly() {
+    using F = Residue<998244353>;
+    auto a = std::make_unique<SquareMatrix<N, F>>();
+    fillMatrix(*a);
+    Polynomial<F> p;
+    double hessenberg = measure([&]() { p = charpoly(*a); });
+    Polynomial<F> m;
+    double krylov = measure([&]() { m = minpoly(*a); });
+    bool agree = true;
+    double determinants = measure([&]() {
+        auto shifted = std::make_unique<SquareMatrix<N, F>>();
+        for (size_t t = 0; t <= N; ++t) {
+            F point(static_cast<long long>(t));
+            *shifted = *a;
+            *shifted *= F(-1);
+            for (size_t i = 0; i < N; ++i) {
+                (*shifted)[i][i] += point;
+            }
+            agree = agree && shifted->det() == p(point);
+        }
+    });
+    std::cout << "charpoly " << N << "x" << N << ": Hessenberg " << hessenberg
+              << " ms, " << N + 1 << " determinants " << determinants
+              << " ms" << (agree ? "" : " (mismatch)") << "; minpoly degree "
+              << m.degree() << " in " << krylov << " ms" << std::endl;
+}
+
+template <size_t N>
+void benchBatch(size_t count) {
+    std::vector<SquareMatrix<N, double>> matrices(count);
+    MatrixBatch<N, N, double> batch(count);
+    for (size_t k = 0; k < count; ++k) {
+        for (size_t i = 0; i < N; ++i) {
+            for (size_t j = 0; j < N; ++j) {
+                matrices[k][i][j] =
+                    static_cast<double>((i * 131 + j * 71 + k) % 1000);
+            }
+            matrices[k][i][i] += 1000;
+        }
+        batch.set(k, matrices[k]);
+    }
+    std::vector<SquareMatrix<N, double>> products(count);
+    double multiply = measure([&]() {
+        for (size_t k = 0; k < count; ++k) {
+            products[k] = matrices[k] * matrices[k];
+        }
+    });
+    double invert = measure([&]() {
+        for (size_t k = 0; k < count; ++k) {
+            products[k] = matrices[k].inverted();
+        }
+    });
+    std::vector<double> det(count);
+    double det_time = measure([&]() {
+        for (size_t k = 0; k < count; ++k) {
+            det[k] = matrices[k].det();
+        }
+    });
+    std::unique_ptr<MatrixBatch<N, N, double>> product;
+    double batch_multiply = measure([&]() {
+        product = std::make_unique<MatrixBatch<N, N, double>>(batch * batch);
+    });
+    double batch_invert = measure([&]() {
+        product =
+            std::make_unique<MatrixBatch<N, N, double>>(batch.inverted());
+    });
+    double batch_det = measure([&]() { det = batch.det(); });
+    std::cout << count << " matrices " << N << "x" << N
+              << " one at a time: multiply " << multiply << " ms, invert "
+              << invert << " ms, det " << det_time << " ms; batched: multiply "
+              << batch_multiply << " ms, invert " << batch_invert
+              << " ms, det " << batch_det << " ms" << std::endl;
+}
+
+int main() {
+    benchLimbPool();
+    benchMultiplySizes<double>("double");
+    benchMultiplySizes<Residue<998244353>>("Residue<998244353>");
+    benchParallel<512, double>("double");
+    benchParallel<512, Residue<998244353>>("Residue<998244353>");
+    benchSimd<512, double>("double");
+    benchSimd<512, float>("float");
+    benchSparse(5000);
+    benchPolynomial(1 << 14);
+    benchCharpoly<128>();
+    benchRationalElimination<256>();
+    benchBatch<3>(1 << 20);
+    benchBatch<4>(1 << 20);
+    return 0;
+}
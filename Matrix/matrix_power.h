@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include "matrix.h"
+
+// a * b modulo x^d - sum_i recurrence[i] x^(d - 1 - i) for polynomials of
+// degree below d, coefficients lowest first.
+template <typename Field>
+std::vector<Field> multiplyModRecurrence(const std::vector<Field>& a,
+                                         const std::vector<Field>& b,
+                                         const std::vector<Field>& recurrence) {
+    size_t d = recurrence.size();
+    std::vector<Field> product(2 * d - 1, Field(0));
+    for (size_t i = 0; i < d; ++i) {
+        if (a[i] == Field(0)) {
+            continue;
+        }
+        for (size_t j = 0; j < d; ++j) {
+            product[i + j] += a[i] * b[j];
+        }
+    }
+    for (size_t k = product.size() - 1; k >= d; --k) {
+        for (size_t i = 0; i < d; ++i) {
+            product[k - 1 - i] += product[k] * recurrence[i];
+        }
+    }
+    product.resize(d);
+    return product;
+}
+
+// Kitamasa's method: x^exponent modulo the characteristic polynomial of the
+// recurrence a[n] = sum_i recurrence[i] a[n - 1 - i], in O(d^2 log e).
+template <typename Field>
+std::vector<Field> kitamasa(const std::vector<Field>& recurrence,
+                            uint64_t exponent) {
+    size_t d = recurrence.size();
+    std::vector<Field> result(d, Field(0));
+    std::vector<Field> base(d, Field(0));
+    if (d == 1) {
+        result[0] = Field(1);
+        base[0] = recurrence[0];
+    } else {
+        result[0] = Field(1);
+        base[1] = Field(1);
+    }
+    for (; exponent > 0; exponent >>= 1) {
+        if (exponent & 1) {
+            result = multiplyModRecurrence(result, base, recurrence);
+        }
+        base = multiplyModRecurrence(base, base, recurrence);
+    }
+    return result;
+}
+
+// Term n of a[n] = sum_i recurrence[i] a[n - 1 - i] from a[0..d).
+template <typename Field>
+Field linearRecurrence(const std::vector<Field>& recurrence,
+                       const std::vector<Field>& initial, uint64_t n) {
+    std::vector<Field> coefficients = kitamasa(recurrence, n);
+    Field term(0);
+    for (size_t i = 0; i < coefficients.size(); ++i) {
+        term += coefficients[i] * initial[i];
+    }
+    return term;
+}
+
+// First row arbitrary, row i > 0 the unit vector e_(i-1): the transition
+// matrix of a linear recurrence on the state (a[n], ..., a[n - N + 1]).
+template <size_t N, typename Field>
+bool isCompanion(const SquareMatrix<N, Field>& m) {
+    for (size_t i = 1; i < N; ++i) {
+        for (size_t j = 0; j < N; ++j) {
+            if (m[i][j] != Field(j + 1 == i ? 1 : 0)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Row i of m^e is row 0 of m^(e - i), whose entry j is the coefficient of
+// x^(N - 1 - j) in x^(e - i + N - 1) mod the characteristic polynomial.
+template <size_t N, typename Field>
+SquareMatrix<N, Field> companionPow(const SquareMatrix<N, Field>& m,
+                                    uint64_t exponent) {
+    std::vector<Field> recurrence(m[0].begin(), m[0].end());
+    std::vector<Field> power = kitamasa(recurrence, exponent);
+    SquareMatrix<N, Field> result;
+    for (size_t i = N; i > 0; --i) {
+        for (size_t j = 0; j < N; ++j) {
+            result[i - 1][j] = power[N - 1 - j];
+        }
+        if (i > 1) {
+            Field top = power[N - 1];
+            for (size_t k = N - 1; k > 0; --k) {
+                power[k] = power[k - 1] + top * recurrence[N - 1 - k];
+            }
+            power[0] = top * recurrence[N - 1];
+        }
+    }
+    return result;
+}
+
+// Binary exponentiation on three heap buffers that trade places, so the
+// result and power are never copied or reallocated per step. The multiply
+// itself still allocates temporaries on some paths: Strassen blocks above
+// strassenCutoff(), and a row of accumulators per band for fields with an
+// Accumulator. Companion matrices take the Kitamasa path.
+template <size_t N, typename Field>
+SquareMatrix<N, Field> pow(const SquareMatrix<N, Field>& m,
+                           uint64_t exponent) {
+    if (exponent + 1 >= N && isCompanion(m)) {
+        return companionPow(m, exponent);
+    }
+    std::vector<Field> result(N * N, Field(0));
+    std::vector<Field> base(N * N);
+    std::vector<Field> scratch(N * N);
+    for (size_t i = 0; i < N; ++i) {
+        result[i * N + i] = Field(1);
+        std::copy(m[i].begin(), m[i].end(), base.begin() + i * N);
+    }
+    auto rows = [](std::vector<Field>& buffer) {
+        return StridedRows<Field>{buffer.data(), N};
+    };
+    for (; exponent > 0; exponent >>= 1) {
+        if (exponent & 1) {
+            multiplyInto<Field>(rows(result), rows(base), rows(scratch), N, N,
+                                N);
+            std::swap(result, scratch);
+        }
+        if (exponent > 1) {
+            multiplyInto<Field>(rows(base), rows(base), rows(scratch), N, N,
+                                N);
+            std::swap(base, scratch);
+        }
+    }
+    SquareMatrix<N, Field> power;
+    for (size_t i = 0; i < N; ++i) {
+        std::copy(result.begin() + i * N, result.begin() + (i + 1) * N,
+                  power[i].begin());
+    }
+    return power;
+}
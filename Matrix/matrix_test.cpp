@@ -1,6 +1,1093 @@
 #include "matrix.h"
+#include "biginteger_vector.h"
+#include "charpoly.h"
+#include "crt.h"
+#include "dynamic_matrix.h"
+#include "lu_decomposition.h"
+#include "matrix_batch.h"
+#include "matrix_power.h"
+#include "modular.h"
+#include "multimodular.h"
+#include "polynomial.h"
+#include "reduction.h"
+#include "simd.h"
+#include "sparse_matrix.h"
+
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+void testBigIntegerVector() {
+    std::vector<BigInteger> a = {BigInteger("123456789012345678901234567890"),
+                                 BigInteger(-5), BigInteger(0),
+                                 BigInteger("-999999999999999999"),
+                                 BigInteger(7)};
+    std::vector<BigInteger> b = {BigInteger(10), BigInteger(5),
+                                 BigInteger("-1000000000000000000000"),
+                                 BigInteger(1), BigInteger(7)};
+    BigIntegerVector va(a);
+    BigIntegerVector vb(b);
+    BigIntegerVector sum = va + vb;
+    BigIntegerVector diff = va - vb;
+    for (size_t i = 0; i < a.size(); ++i) {
+        assert(sum.get(i) == a[i] + b[i]);
+        assert(diff.get(i) == a[i] - b[i]);
+    }
+    std::vector<int> order = va.compare(vb);
+    for (size_t i = 0; i < a.size(); ++i) {
+        assert(order[i] == (a[i] < b[i] ? -1 : (b[i] < a[i] ? 1 : 0)));
+    }
+    BigIntegerVector scaled = va * -1234567890123456789LL;
+    for (size_t i = 0; i < a.size(); ++i) {
+        assert(scaled.get(i) == a[i] * BigInteger(-1234567890123456789LL));
+    }
+    assert((va * 0).get(0) == 0);
+    BigInteger total = 0;
+    for (const BigInteger& x : a) {
+        total += x;
+    }
+    assert(va.sum() == total);
+    BigIntegerVector acc(a.size());
+    for (int k = 0; k < 1000; ++k) {
+        acc -= va;
+    }
+    assert(acc.get(0) == a[0] * BigInteger(-1000));
+    assert(acc.get(3) == a[3] * BigInteger(-1000));
+    // Values written by set() compare like equal values from arithmetic.
+    std::vector<BigInteger> c = {BigInteger(-1), BigInteger(-1),
+                                 BigInteger("-1000000000000000000000"),
+                                 BigInteger(3)};
+    BigIntegerVector vc(c);
+    BigIntegerVector vd(std::vector<BigInteger>(c.size(), BigInteger(0)));
+    vd -= BigIntegerVector(std::vector<BigInteger>(c.size(), BigInteger(1)));
+    vd.set(1, BigInteger(-2));
+    vd.set(2, BigInteger("-1000000000000000000001"));
+    std::vector<int> forward = vc.compare(vd);
+    std::vector<int> backward = vd.compare(vc);
+    std::vector<int> expected = {0, 1, 1, 1};
+    for (size_t i = 0; i < c.size(); ++i) {
+        assert(forward[i] == expected[i] && backward[i] == -expected[i]);
+        assert(vc.get(i) == c[i]);
+    }
+}
+
+void testRationalCompare() {
+    std::vector<Rational> values = {
+        Rational(1) / Rational(3),
+        Rational(-2) / Rational(7),
+        Rational(0),
+        Rational(BigInteger("123456789012345678901234567890")) /
+            Rational(BigInteger("987654321")),
+        Rational(BigInteger("123456789012345678901234567891")) /
+            Rational(BigInteger("987654321")),
+        Rational(2) / Rational(6),
+        Rational(BigInteger("-1000000000000000000000000")) / Rational(3),
+        Rational(BigInteger("333333333333333333333")) /
+            Rational(BigInteger("1000000000000000000000"))};
+    for (const Rational& a : values) {
+        for (const Rational& b : values) {
+            Rational diff = a - b;
+            assert((a < b) == (diff < Rational(0)));
+            assert((a == b) == (diff == Rational(0)));
+        }
+    }
+    assert(values[0] == values[5]);
+    assert(values[3] < values[4]);
+    assert(values[6] < values[1]);
+    assert(values[7] < values[0]);
+    assert(BigInteger::compareProducts(BigInteger(-3), BigInteger(4),
+                                       BigInteger(6), BigInteger(-2)) == 0);
+}
+
+void testReduction() {
+    std::vector<Rational> harmonic;
+    Rational expected_sum = 0;
+    for (int i = 1; i <= 300; ++i) {
+        harmonic.push_back(Rational(1) / Rational(i));
+        expected_sum += harmonic.back();
+    }
+    ThreadPool pool(4);
+    assert(sum(harmonic.begin(), harmonic.end(), pool) == expected_sum);
+    std::vector<BigInteger> factors;
+    BigInteger factorial = 1;
+    for (int i = 1; i <= 200; ++i) {
+        factors.emplace_back(i);
+        factorial *= i;
+    }
+    assert(product(factors.begin(), factors.end(), pool) == factorial);
+    assert(dot(harmonic.begin(), harmonic.begin() + 200, factors.begin(),
+               pool) == Rational(200));
+    assert(sum(factors.begin(), factors.begin(), pool) == 0);
+    // Reductions inside every worker of a pool must not wait on each other.
+    std::atomic<size_t> started = 0;
+    std::vector<std::future<Rational>> nested;
+    for (size_t i = 0; i < pool.size(); ++i) {
+        nested.push_back(pool.submit([&harmonic, &pool, &started]() {
+            ++started;
+            while (started < pool.size()) {
+                std::this_thread::yield();
+            }
+            return sum(harmonic.begin(), harmonic.end(), pool);
+        }));
+    }
+    for (std::future<Rational>& future : nested) {
+        assert(future.get() == expected_sum);
+    }
+}
+
+void testCRT() {
+    std::vector<long long> primes = {998244353, 1000000007, 1000000009,
+                                     2305843009213693951LL, 469762049};
+    CRT crt(primes);
+    BigInteger value("-123456789012345678901234567890123456789");
+    std::vector<long long> residues = crt.reduce(value);
+    for (size_t i = 0; i < primes.size(); ++i) {
+        assert(residues[i] == value.remainder(primes[i]));
+        assert(BigInteger(residues[i]) ==
+               (value % primes[i] + primes[i]) % primes[i]);
+    }
+    assert(crt.reconstructSigned(residues) == value);
+    assert(crt.reconstruct(residues) == value + crt.modulus());
+    Rational fraction = Rational(BigInteger("-12345678901234567")) /
+                        Rational(BigInteger("98765432109876"));
+    CRT small({1000000007, 1000000009, 998244353, 469762049, 167772161});
+    std::vector<long long> images;
+    for (long long p : small.moduli()) {
+        long long numerator = BigInteger("-12345678901234567").remainder(p);
+        long long denominator = BigInteger("98765432109876").remainder(p);
+        images.push_back(static_cast<long long>(
+            mulMod(static_cast<uint64_t>(numerator),
+                   inverseMod(static_cast<uint64_t>(denominator),
+                              static_cast<uint64_t>(p)),
+                   static_cast<uint64_t>(p))));
+    }
+    std::optional<Rational> recovered = CRT::rationalReconstruct(
+        small.reconstruct(images), small.modulus());
+    assert(recovered.has_value() && *recovered == fraction);
+    assert(!CRT::rationalReconstruct(3, 7).has_value());
+}
+
+void testBitwise() {
+    BigInteger a("123456789012345678901234567890");
+    BigInteger b("-98765432109876543210");
+    BigInteger power = 1;
+    for (int i = 0; i < 100; ++i) {
+        power *= 2;
+    }
+    assert((a << 100) == a * power);
+    assert((a >> 100) == 0);
+    assert(((a * power) >> 100) == a);
+    assert((b >> 3) == (b - 7) / 8);
+    assert((BigInteger(-1) >> 5) == -1);
+    assert((BigInteger(-8) >> 3) == -1);
+    assert((BigInteger(12) & BigInteger(10)) == 8);
+    assert((BigInteger(12) | BigInteger(10)) == 14);
+    assert((BigInteger(12) ^ BigInteger(10)) == 6);
+    assert((BigInteger(-12) & BigInteger(10)) == 0);
+    assert((BigInteger(-12) | BigInteger(10)) == -2);
+    assert((BigInteger(-12) ^ BigInteger(-10)) == 2);
+    assert(((a ^ b) ^ b) == a);
+    assert((a & b) + (a | b) == a + b);
+    assert(power.bitLength() == 101);
+    assert(BigInteger(-255).bitLength() == 8);
+    assert(BigInteger(0).bitLength() == 0);
+    assert((a * power).countTrailingZeros() == 101);
+    assert(BigInteger("1000000000000000000000000000").countTrailingZeros() ==
+           27);
+    assert(BigInteger(-96).countTrailingZeros() == 5);
+    assert(gcd(BigInteger(-12), BigInteger(18)) == 6);
+    assert(gcd(BigInteger(0), BigInteger(-5)) == 5);
+    assert(gcd(power * 35, power * power * 21) == power * 7);
+}
+
+size_t& countedAllocations() {
+    static size_t count = 0;
+    return count;
+}
+
+void* countingAllocate(size_t bytes) {
+    ++countedAllocations();
+    return ::operator new(bytes);
+}
+
+void countingDeallocate(void* pointer, size_t /*bytes*/) {
+    ::operator delete(pointer);
+}
+
+// Runs on a fresh thread, whose pool starts empty and is torn down before
+// join() returns, so every block the counting resource hands out goes
+// back to it and no earlier block reaches it.
+void testLimbAllocator() {
+    LimbResource previous = getLimbResource();
+    setLimbResource({countingAllocate, countingDeallocate});
+    std::thread isolated([]() {
+        setLimbPoolEnabled(false);
+        BigInteger a = BigInteger("123456789012345678901234567890") * 3;
+        assert(countedAllocations() > 0);
+        setLimbPoolEnabled(true);
+        for (int i = 0; i < 100; ++i) {
+            a = a * 3 / 3;
+        }
+        size_t warm = countedAllocations();
+        for (int i = 0; i < 100; ++i) {
+            a = a * 3 / 3;
+        }
+        assert(countedAllocations() == warm);
+        assert(a == BigInteger("370370367037037036703703703670"));
+    });
+    isolated.join();
+    setLimbResource(previous);
+}
+
+template <size_t M, size_t N, size_t K, typename Field>
+Matrix<M, K, Field> naiveProduct(const Matrix<M, N, Field>& a,
+                                 const Matrix<N, K, Field>& b) {
+    Matrix<M, K, Field> result;
+    for (size_t i = 0; i < M; ++i) {
+        for (size_t j = 0; j < K; ++j) {
+            Field cell(0);
+            for (size_t k = 0; k < N; ++k) {
+                cell += a[i][k] * b[k][j];
+            }
+            result[i][j] = cell;
+        }
+    }
+    return result;
+}
+
+template <size_t M, size_t N, typename Field>
+Matrix<M, N, Field> sampleMatrix(int seed) {
+    Matrix<M, N, Field> result;
+    for (size_t i = 0; i < M; ++i) {
+        for (size_t j = 0; j < N; ++j) {
+            result[i][j] = Field(static_cast<int>((i * 31 + j * 17 + 7) *
+                                                  (seed + 3) % 23) -
+                                 11);
+        }
+    }
+    return result;
+}
+
+void testMatrixMultiply() {
+    auto a = sampleMatrix<70, 130, Residue<998244353>>(1);
+    auto b = sampleMatrix<130, 67, Residue<998244353>>(2);
+    assert(a * b == naiveProduct(a, b));
+    auto c = sampleMatrix<9, 5, Rational>(3);
+    auto d = sampleMatrix<5, 11, Rational>(4);
+    assert(c * d == naiveProduct(c, d));
+    auto e = sampleMatrix<65, 65, double>(5);
+    SquareMatrix<65, double> f = e;
+    f *= e;
+    assert(f == naiveProduct(e, e));
+    Matrix<2, 2, int> g = {{1, 2}, {3, 4}};
+    Matrix<2, 2, int> expected = {{7, 10}, {15, 22}};
+    assert(g * g == expected);
+}
+
+void testStrassen() {
+    size_t cutoff = strassenCutoff();
+    strassenCutoff() = 4;
+    auto a = sampleMatrix<19, 19, Rational>(6);
+    auto b = sampleMatrix<19, 19, Rational>(7);
+    b[3][5] = Rational(1) / Rational(3);
+    assert(a * b == naiveProduct(a, b));
+    auto c = sampleMatrix<100, 100, Residue<998244353>>(8);
+    auto d = sampleMatrix<100, 100, Residue<998244353>>(9);
+    assert(c * d == naiveProduct(c, d));
+    strassenCutoff() = 1;
+    auto e = sampleMatrix<5, 5, Residue<17>>(10);
+    assert(e * e == naiveProduct(e, e));
+    strassenCutoff() = cutoff;
+}
+
+template <size_t P>
+void checkResidueArithmetic(long long x, long long y) {
+    auto reference = [](const BigInteger& value) {
+        return static_cast<long long>(value.remainder(
+            static_cast<long long>(P)));
+    };
+    Residue<P> a(x);
+    Residue<P> b(y);
+    assert(static_cast<long long>(a) == reference(x));
+    assert(static_cast<long long>(a + b) == reference(BigInteger(x) + y));
+    assert(static_cast<long long>(a - b) == reference(BigInteger(x) - y));
+    assert(static_cast<long long>(b - a) == reference(BigInteger(y) - x));
+    assert(static_cast<long long>(a * b) ==
+           reference(BigInteger(x) * BigInteger(y)));
+    typename Residue<P>::Accumulator sum;
+    BigInteger expected = 0;
+    for (long long i = 1; i <= 20; ++i) {
+        sum.add(a * Residue<P>(i), b);
+        expected += BigInteger(x) * i * y;
+    }
+    assert(static_cast<long long>(sum.get()) == reference(expected));
+}
+
+void testPrimality() {
+    static_assert(isPrime<2>);
+    static_assert(isPrime<998244353>);
+    static_assert(isPrime<2305843009213693951ULL>);
+    static_assert(isPrime<18446744073709551557ULL>);
+    static_assert(!isPrime<1>);
+    static_assert(!isPrime<0>);
+    static_assert(!isPrime<3215031751>);
+    static_assert(!isPrime<3825123056546413051ULL>);
+    static_assert(!isPrime<1000000007ULL * 998244353ULL>);
+    using Big = Residue<2305843009213693951ULL>;
+    assert(Big(123456789) / Big(-987654321) * Big(-987654321) ==
+           Big(123456789));
+}
+
+void testResidue() {
+    checkResidueArithmetic<998244353>(123456789123LL, -987654321987LL);
+    checkResidueArithmetic<2305843009213693951ULL>(-4611686018427387000LL,
+                                                   2305843009213693950LL);
+    checkResidueArithmetic<4611686018427387904ULL>(4611686018427387903LL,
+                                                   -3);
+    checkResidueArithmetic<7>(-1, 13);
+    assert(Residue<13>(5) / Residue<13>(7) * Residue<13>(7) == Residue<13>(5));
+    auto a = sampleMatrix<20, 30, Residue<2305843009213693951ULL>>(11);
+    auto b = sampleMatrix<30, 10, Residue<2305843009213693951ULL>>(12);
+    assert(a * b == naiveProduct(a, b));
+}
+
+template <size_t N, typename Field>
+SquareMatrix<N, Field> identity() {
+    SquareMatrix<N, Field> result;
+    for (size_t i = 0; i < N; ++i) {
+        result[i][i] = Field(1);
+    }
+    return result;
+}
+
+void testElimination() {
+    SquareMatrix<3> a = {{2, 0, 1}, {1, 3, 2}, {1, 1, 2}};
+    assert(a.det() == Rational(6));
+    assert(a.rank() == 3);
+    assert(a * a.inverted() == (identity<3, Rational>()));
+    SquareMatrix<3> singular = {{1, 2, 3}, {2, 4, 6}, {0, 1, 1}};
+    assert(singular.det() == Rational(0));
+    assert(singular.rank() == 2);
+    using F = Residue<1000000007>;
+    // Column 0 has no pivot, which must not use up row 0.
+    SquareMatrix<3, F> shifted = {{0, 1, 0}, {0, 1, 0}, {0, 0, 1}};
+    assert(shifted.rank() == 2 && DynamicMatrix<F>(shifted).rank() == 2);
+    assert(shifted.det() == F(0));
+    Matrix<3, 4, F> wide = {{1, 2, 3, 4}, {2, 4, 7, 9}, {0, 0, 1, 1}};
+    assert(wide.rank() == 2 && DynamicMatrix<F>(wide).rank() == 2);
+    auto b = sampleMatrix<12, 12, F>(13);
+    for (size_t i = 0; i < 12; ++i) {
+        b[i][i] += F(static_cast<long long>(i) + 50);
+    }
+    assert(b * b.inverted() == (identity<12, F>()));
+    assert(b.det() * b.inverted().det() == F(1));
+    std::vector<F> values = {F(3), F(5), F(-7), F(123456789)};
+    std::vector<F> inverses = values;
+    batchInverse(inverses);
+    for (size_t i = 0; i < values.size(); ++i) {
+        assert(values[i] * inverses[i] == F(1));
+    }
+    using Big = Residue<2305843009213693951ULL>;
+    assert(Big(-5).inverse() * Big(-5) == Big(1));
+}
+
+void testFractionFree() {
+    SquareMatrix<3> a = {{2, 0, 1}, {1, 3, 2}, {1, 1, 2}};
+    a[0][1] = Rational(1) / Rational(2);
+    a[2][2] = Rational(-7) / Rational(3);
+    SquareMatrix<3> b = {{0, 1, 4}, {5, 0, 1}, {2, 2, 0}};
+    b[1][1] = Rational(3) / Rational(4);
+    assert((a * b).det() == a.det() * b.det());
+    assert(a * a.inverted() == (identity<3, Rational>()));
+    assert(b.inverted() * b == (identity<3, Rational>()));
+    auto c = sampleMatrix<8, 8, Rational>(14);
+    for (size_t i = 0; i < 8; ++i) {
+        c[i][(i * 3) % 8] += Rational(1) / Rational(static_cast<int>(i) + 2);
+    }
+    assert(c * c.inverted() == (identity<8, Rational>()));
+    assert(c.inverted().det() * c.det() == Rational(1));
+    Matrix<2, 4> wide = {{0, 0, 1, 2}, {0, 0, 2, 4}};
+    assert(wide.rank() == 1);
+    Matrix<3, 2> tall = {{1, 2}, {2, 4}, {3, 7}};
+    assert(tall.rank() == 2);
+    SquareMatrix<3> swapped = {{0, 1, 0}, {1, 0, 0}, {0, 0, 1}};
+    assert(swapped.det() == Rational(-1));
+    std::vector<Rational> fractions = {Rational(1) / Rational(6),
+                                       Rational(-1) / Rational(4),
+                                       Rational(7) / Rational(10)};
+    std::vector<BigInteger> scales;
+    std::vector<BigInteger> cleared = clearDenominators(fractions, 1, 3,
+                                                        scales);
+    assert(scales[0] == 60);
+    assert(cleared == (std::vector<BigInteger>{10, -15, 42}));
+}
+
+void testMultimodular() {
+    auto c = sampleMatrix<8, 8, Rational>(14);
+    BigInteger huge = BigInteger(1000000007) * BigInteger(998244353);
+    for (size_t i = 0; i < 8; ++i) {
+        c[i][(i * 3) % 8] += Rational(huge * huge) /
+                             Rational(static_cast<int>(i) + 2);
+    }
+    assert(multimodularDet(c) == c.det());
+    std::array<Rational, 8> b;
+    for (size_t i = 0; i < 8; ++i) {
+        b[i] = Rational(static_cast<int>(i) - 3) / Rational(5);
+    }
+    std::optional<std::array<Rational, 8>> x = multimodularSolve(c, b);
+    assert(x.has_value());
+    for (size_t i = 0; i < 8; ++i) {
+        Rational row = 0;
+        for (size_t j = 0; j < 8; ++j) {
+            row += c[i][j] * (*x)[j];
+        }
+        assert(row == b[i]);
+    }
+    SquareMatrix<3> singular = {{1, 2, 3}, {2, 4, 6}, {1, 0, 1}};
+    assert(multimodularDet(singular) == Rational(0));
+    assert(!multimodularSolve(singular, {1, 2, 3}).has_value());
+    assert(multimodularRank(singular) == 2);
+    Matrix<2, 4> wide = {{0, 0, 1, 2}, {0, 0, 2, 4}};
+    assert(multimodularRank(wide) == 1);
+    assert(multimodularRank(c) == 8);
+    // Every worker of the global pool computing a determinant at once.
+    ThreadPool& pool = ThreadPool::global();
+    std::atomic<size_t> started = 0;
+    std::vector<std::future<Rational>> nested;
+    for (size_t i = 0; i < pool.size(); ++i) {
+        nested.push_back(pool.submit([&c, &pool, &started]() {
+            ++started;
+            while (started < pool.size()) {
+                std::this_thread::yield();
+            }
+            return multimodularDet(c);
+        }));
+    }
+    for (std::future<Rational>& future : nested) {
+        assert(future.get() == c.det());
+    }
+}
+
+void testDynamicMatrix() {
+    auto a = sampleMatrix<8, 8, Rational>(14);
+    for (size_t i = 0; i < 8; ++i) {
+        a[i][(i * 5) % 8] += Rational(1) / Rational(static_cast<int>(i) + 3);
+    }
+    DynamicMatrix<Rational> dynamic(a);
+    assert(dynamic.det() == a.det());
+    assert(dynamic.rank() == a.rank());
+    assert(dynamic.trace() == a.trace());
+    assert(dynamic.inverted() == DynamicMatrix<Rational>(a.inverted()));
+    assert(dynamic * dynamic.inverted() ==
+           DynamicMatrix<Rational>::identity(8));
+    auto b = sampleMatrix<8, 3, Rational>(15);
+    assert(dynamic * DynamicMatrix<Rational>(b) ==
+           DynamicMatrix<Rational>(a * b));
+    assert(DynamicMatrix<Rational>(b).transposed() ==
+           DynamicMatrix<Rational>(b.transposed()));
+    auto c = sampleMatrix<150, 150, Residue<998244353>>(16);
+    auto d = sampleMatrix<150, 150, Residue<998244353>>(17);
+    DynamicMatrix<Residue<998244353>> dynamic_c(c);
+    DynamicMatrix<Residue<998244353>> dynamic_d(d);
+    DynamicMatrix<Residue<998244353>> product = dynamic_c * dynamic_d;
+    assert(product == DynamicMatrix<Residue<998244353>>(naiveProduct(c, d)));
+    assert(product.det() == c.det() * d.det());
+    assert(dynamic_c.rank() == c.rank());
+    std::istringstream in("2 3\n1 2 3\n2 4 7\n");
+    DynamicMatrix<Rational> wide;
+    in >> wide;
+    assert(wide.rows() == 2 && wide.columns() == 3);
+    assert(wide.rank() == 2);
+    assert((wide == DynamicMatrix<Rational>{{1, 2, 3}, {2, 4, 7}}));
+}
+
+void testParallel() {
+    size_t threads = parallelThreads();
+    size_t threshold = parallelThreshold();
+    auto a = sampleMatrix<40, 40, Residue<998244353>>(18);
+    auto b = sampleMatrix<40, 40, Residue<998244353>>(19);
+    auto c = sampleMatrix<10, 10, Rational>(20);
+    c[2][7] = Rational(5) / Rational(3);
+    parallelThreads() = 1;
+    SquareMatrix<40, Residue<998244353>> product = a * b;
+    auto inverted = a.inverted();
+    size_t rank = b.rank();
+    Rational det = c.det();
+    auto c_inverted = c.inverted();
+    parallelThreads() = 4;
+    parallelThreshold() = 1;
+    assert(a * b == product);
+    assert(a.inverted() == inverted);
+    assert(b.rank() == rank);
+    assert(c.det() == det);
+    assert(c.inverted() == c_inverted);
+    parallelThreads() = threads;
+    parallelThreshold() = threshold;
+}
+
+void testExpressions() {
+    using Field = Residue<998244353>;
+    auto a = sampleMatrix<6, 4, Field>(21);
+    auto b = sampleMatrix<4, 6, Field>(22);
+    auto c = sampleMatrix<6, 6, Field>(23);
+    auto d = sampleMatrix<6, 6, Field>(24);
+    SquareMatrix<6, Field> expected = naiveProduct(a, b);
+    expected += c;
+    expected -= d;
+    SquareMatrix<6, Field> result = a * b + c - d;
+    assert(result == expected);
+    assert(c - d + a * b == expected);
+    assert((Field(3) * (c + d)).trace() == Field(3) * (c.trace() + d.trace()));
+    SquareMatrix<6, Field> scaled = Field(2) * (a * b);
+    assert(scaled == naiveProduct(a, b) + naiveProduct(a, b));
+    expected = naiveProduct(c, d) + c;
+    result = c;
+    result = result * d + result;
+    assert(result == expected);
+    result = c;
+    result += result * d;
+    assert(result == expected);
+    result = c;
+    result *= d;
+    assert(result == naiveProduct(c, d));
+    result -= (c + d) * c;
+    SquareMatrix<6, Field> sum = c + d;
+    assert(result + naiveProduct(sum, c) == naiveProduct(c, d));
+    SquareMatrix<3> e = {{1, 2, 0}, {0, 1, 0}, {2, 0, 1}};
+    assert((e * e - e).det() == Rational(0));
+    assert((e * e.inverted() - identity<3, Rational>()).rank() == 0);
+    SquareMatrix<3> inverse = e.inverted();
+    SquareMatrix<3> unit = identity<3, Rational>();
+    auto held = e.inverted() + e;
+    auto product = e * e.inverted();
+    assert(SquareMatrix<3>(held) == inverse + e);
+    assert(product == unit);
+    assert((c * d)[1][2] == naiveProduct(c, d)[1][2]);
+    assert((c + d).getRow(0) == sum.getRow(0));
+    assert((c - d).getColumn(5) == (c - d).eval().getColumn(5));
+}
+
+void testLUDecomposition() {
+    using Field = Residue<998244353>;
+    auto a = sampleMatrix<12, 12, Field>(25);
+    for (size_t i = 0; i < 12; ++i) {
+        a[i][(i * 7) % 12] += Field(static_cast<int>(i) + 1);
+    }
+    LUDecomposition<12, Field> lu(a);
+    SquareMatrix<12, Field> permuted;
+    for (size_t i = 0; i < 12; ++i) {
+        permuted[i] = a[lu.permutation()[i]];
+    }
+    assert(lu.lower() * lu.upper() == permuted);
+    assert(lu.det() == a.det());
+    assert(lu.rank() == 12 && !lu.singular());
+    auto b = sampleMatrix<12, 3, Field>(26);
+    assert(a * lu.solve(b) == b);
+    assert(lu.inverted() == a.inverted());
+    SquareMatrix<3> c = {{0, 2, 1}, {1, 1, 1}, {2, 1, 3}};
+    LUDecomposition<3> rational(c);
+    assert(rational.det() == c.det());
+    assert(rational.inverted() == c.inverted());
+    std::array<Rational, 3> x = rational.solve({1, 2, 3});
+    assert(c[0][0] * x[0] + c[0][1] * x[1] + c[0][2] * x[2] == Rational(1));
+    SquareMatrix<3> singular = {{1, 2, 3}, {2, 4, 6}, {1, 0, 1}};
+    LUDecomposition<3> singular_lu(singular);
+    assert(singular_lu.singular() && singular_lu.rank() == 2);
+    assert(singular_lu.det() == Rational(0));
+    SquareMatrix<3> skipped = {{1, 2, 3}, {2, 4, 9}, {3, 6, 11}};
+    LUDecomposition<3> skipped_lu(skipped);
+    SquareMatrix<3> skipped_permuted;
+    for (size_t i = 0; i < 3; ++i) {
+        skipped_permuted[i] = skipped[skipped_lu.permutation()[i]];
+    }
+    assert(skipped_lu.rank() == 2);
+    assert(skipped_lu.lower() * skipped_lu.upper() == skipped_permuted);
+    assert(skipped_lu.upper().getRow(2) == SquareMatrix<3>().getRow(2));
+    SquareMatrix<2, double> d = {{1e-12, 1.0}, {1.0, 1.0}};
+    std::array<double, 2> y = LUDecomposition<2, double>(d).solve({1, 2});
+    assert(std::abs(y[0] - 1) < 1e-9 && std::abs(y[1] - 1) < 1e-9);
+}
+
+void testSparseMatrix() {
+    using Field = Residue<998244353>;
+    const size_t n = 60;
+    std::vector<SparseMatrix<998244353>::Entry> entries;
+    for (size_t i = 0; i < n; ++i) {
+        entries.push_back({i, i, Field(static_cast<int>(i) + 2)});
+        entries.push_back({i, (i * 7 + 3) % n, Field(5)});
+        entries.push_back({i, (i * 13 + 1) % n, Field(-3)});
+        entries.push_back({i, (i * 13 + 1) % n, Field(3)});
+    }
+    SparseMatrix<998244353> sparse(n, n, entries);
+    assert(sparse.nonZeros() <= 2 * n);
+    auto dense = std::make_unique<SquareMatrix<n, Field>>();
+    for (const auto& entry : entries) {
+        (*dense)[entry.row][entry.column] += entry.value;
+    }
+    assert(sparse.det().has_value() && *sparse.det() == dense->det());
+    assert(sparse.rank() == dense->rank());
+    std::vector<Field> b(n);
+    for (size_t i = 0; i < n; ++i) {
+        b[i] = Field(static_cast<int>(i * i) - 7);
+    }
+    std::optional<std::vector<Field>> x = sparse.solve(b);
+    assert(x.has_value() && sparse * *x == b);
+    entries.push_back({n - 1, n - 1, Field(-static_cast<int>(n) - 1)});
+    entries.push_back({n - 1, (n * 7 - 4) % n, Field(-5)});
+    for (size_t j = 0; j < n; ++j) {
+        entries.push_back({n - 1, j, (*dense)[0][j]});
+    }
+    SparseMatrix<998244353> singular(n, n, entries);
+    assert(singular.det() == Field(0));
+    // Over Z/2 the only diagonal is 1 and the identity's minimal polynomial
+    // has degree 1, so no attempt can find the determinant.
+    SparseMatrix<2> unlucky(2, 2,
+                            {{0, 0, Residue<2>(1)}, {1, 1, Residue<2>(1)}});
+    assert(!unlucky.det().has_value());
+    SparseMatrix<2>::Vector unit = {Residue<2>(1), Residue<2>(0)};
+    std::optional<SparseMatrix<2>::Vector> unit_solution = unlucky.solve(unit);
+    assert(!unit_solution.has_value() || *unit_solution == unit);
+    assert(singular.rank() == n - 1);
+    assert(!singular.solve(b).has_value());
+    SparseMatrix<998244353> wide(2, 3, {{0, 1, Field(2)}, {1, 1, Field(4)}});
+    assert(wide.rank() == 1);
+    assert(berlekampMassey(std::vector<Field>{Field(1), Field(1), Field(2),
+                                              Field(3), Field(5)}) ==
+           (std::vector<Field>{Field(-1), Field(-1), Field(1)}));
+}
+
+template <size_t N, typename Field>
+SquareMatrix<N, Field> repeatedProduct(const SquareMatrix<N, Field>& m,
+                                       size_t exponent) {
+    SquareMatrix<N, Field> result = identity<N, Field>();
+    for (size_t i = 0; i < exponent; ++i) {
+        result = naiveProduct(result, m);
+    }
+    return result;
+}
+
+void testMatrixPower() {
+    using Field = Residue<998244353>;
+    auto a = sampleMatrix<5, 5, Field>(27);
+    assert(pow(a, 0) == (identity<5, Field>()));
+    assert(pow(a, 37) == repeatedProduct(a, 37));
+    SquareMatrix<4, Field> companion;
+    companion[0] = {Field(3), Field(-1), Field(4), Field(1)};
+    for (size_t i = 1; i < 4; ++i) {
+        companion[i][i - 1] = Field(1);
+    }
+    assert(isCompanion(companion) && !isCompanion(a));
+    for (size_t exponent : {0, 1, 2, 3, 4, 29}) {
+        assert(pow(companion, exponent) ==
+               repeatedProduct(companion, exponent));
+    }
+    uint64_t huge = 1000000000000000000ULL;
+    assert(pow(companion, huge + 12345) ==
+           naiveProduct(pow(companion, huge), pow(companion, 12345)));
+    std::vector<Field> fibonacci = {Field(1), Field(1)};
+    std::vector<Field> initial = {Field(0), Field(1)};
+    Field previous(0);
+    Field current(1);
+    for (size_t i = 1; i < 90; ++i) {
+        Field next = previous + current;
+        previous = current;
+        current = next;
+    }
+    assert(linearRecurrence(fibonacci, initial, 90) == current);
+    SquareMatrix<2> rational = {{1, 1}, {1, 0}};
+    rational[0][1] = Rational(1) / Rational(2);
+    assert(pow(rational, 9) == repeatedProduct(rational, 9));
+}
+
+void testViews() {
+    using Field = Residue<998244353>;
+    auto a = sampleMatrix<6, 4, Field>(28);
+    auto b = sampleMatrix<6, 5, Field>(29);
+    assert(a.transposedView() == a.transposed());
+    assert(a * a.transposedView() == naiveProduct(a, a.transposed()));
+    assert(a.transposedView() * b == naiveProduct(a.transposed(), b));
+    auto c = sampleMatrix<5, 7, Rational>(30);
+    auto d = sampleMatrix<3, 7, Rational>(31);
+    assert(c * d.transposedView() == naiveProduct(c, d.transposed()));
+    SquareMatrix<6, Field> e = naiveProduct(b, b.transposed());
+    e[0][5] += Field(1);
+    SquareMatrix<6, Field> e_transposed = e.transposed();
+    e = e.transposedView();
+    assert(e == e_transposed);
+    e += e.transposedView();
+    assert(e == e_transposed + e_transposed.transposed());
+    assert(a.row(2).size() == 4 && a.row(2)[3] == a[2][3]);
+    StridedSpan<Field> column = a.column(1);
+    column[4] = Field(42);
+    assert(column.size == 6 && a[4][1] == Field(42));
+    SquareMatrix<3, Field> product;
+    multiplyAccumulate<Field>(a.block(1, 1, 3, 2), b.block(0, 2, 2, 3),
+                              product, 3, 2, 3);
+    Matrix<3, 2, Field> a_block;
+    Matrix<2, 3, Field> b_block;
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 2; ++j) {
+            a_block[i][j] = a[i + 1][j + 1];
+            b_block[j][i] = b[j][i + 2];
+        }
+    }
+    assert(product == naiveProduct(a_block, b_block));
+    SquareMatrix<4> f = {
+        {1, 2, 3, 4}, {5, 6, 7, 8}, {2, 4, 6, 8}, {1, 1, 1, 1}};
+    gaussForwardAndReverse<Rational>(f.block(0, 1, 3, 3), 3, 3, false);
+    assert(f[2][1] == Rational(0) && f[2][2] == Rational(0));
+    assert(f[3][0] == Rational(1) && f[0][0] == Rational(1));
+    DynamicMatrix<Field> dynamic(a);
+    assert(dynamic.column(1)[4] == Field(42));
+    assert(dynamic.block(2, 1, 2, 2)[1][0] == a[3][1]);
+}
+
+void testRowOrder() {
+    // Rows of a unit upper triangular matrix in reverse order: every pivot
+    // needs a swap, so the order must carry all of them.
+    using F = Residue<1000000007>;
+    SquareMatrix<7, F> upper = identity<7, F>();
+    for (size_t i = 0; i < 7; ++i) {
+        for (size_t j = i + 1; j < 7; ++j) {
+            upper[i][j] = F(static_cast<long long>(i + 2 * j));
+        }
+    }
+    SquareMatrix<7, F> reversed;
+    for (size_t i = 0; i < 7; ++i) {
+        reversed[i] = upper[6 - i];
+    }
+    SquareMatrix<7, F> copy = reversed;
+    std::vector<size_t> order = identityOrder(7);
+    assert(gaussEliminate<F>(copy, order, 7, 7, false) == 3);
+    assert(order == (std::vector<size_t>{6, 5, 4, 3, 2, 1, 0}));
+    assert(copy[0] == reversed[0]);
+    permuteRows(copy, order, 7);
+    assert(copy == upper && order == identityOrder(7));
+    assert(reversed.det() == F(-1) && reversed.rank() == 7);
+    assert(reversed * reversed.inverted() == (identity<7, F>()));
+    SquareMatrix<7> rational;
+    for (size_t i = 0; i < 7; ++i) {
+        for (size_t j = 0; j < 7; ++j) {
+            rational[i][j] = Rational(static_cast<int>(reversed[i][j]));
+        }
+    }
+    rational[3][1] = Rational(1) / Rational(3);
+    assert(rational * rational.inverted() == (identity<7, Rational>()));
+    assert(rational.det() == DynamicMatrix<Rational>(rational).det());
+    DynamicMatrix<F> dynamic(reversed);
+    assert(dynamic.det() == F(-1));
+    assert(dynamic * dynamic.inverted() == DynamicMatrix<F>::identity(7));
+    dynamic.gaussForwardAndReverse(false);
+    assert(dynamic == DynamicMatrix<F>(upper));
+}
+
+void testSimd() {
+    SimdLevel detected = detectSimdLevel();
+    for (SimdLevel level :
+         {SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        simdLevel() = level;
+        for (size_t n = 0; n < 40; ++n) {
+            std::vector<float> x(n);
+            std::vector<float> y(n, 1);
+            for (size_t i = 0; i < n; ++i) {
+                x[i] = static_cast<float>(i);
+            }
+            simdKernels<float>().axpy(y.data(), x.data(), 2, n);
+            simdKernels<float>().scale(y.data(), 3, n);
+            for (size_t i = 0; i < n; ++i) {
+                assert(y[i] == static_cast<float>(3 + 6 * i));
+            }
+            float dot = simdKernels<float>().dot(x.data(), x.data(), n);
+            assert(n == 0 || dot == static_cast<float>((n - 1) * n *
+                                                       (2 * n - 1) / 6));
+        }
+        auto a = sampleMatrix<37, 70, double>(32);
+        auto b = sampleMatrix<70, 45, double>(33);
+        assert(a * b == naiveProduct(a, b));
+        Matrix<45, 70, double> b_transposed = b.transposed();
+        assert(a * b_transposed.transposedView() == naiveProduct(a, b));
+        auto c = sampleMatrix<21, 19, float>(34);
+        auto d = sampleMatrix<19, 23, float>(35);
+        assert(c * d == naiveProduct(c, d));
+        auto e = a;
+        e += a;
+        e *= 0.5;
+        assert(e == a);
+        e -= a;
+        assert(e == (Matrix<37, 70, double>()));
+        DynamicMatrix<float> f(c);
+        f += f;
+        f *= 0.5F;
+        assert(f == DynamicMatrix<float>(c));
+        // Without partial pivoting the 1 in the corner is lost next to
+        // 1 / 1e-20 and the inverse comes out as {{0, 1}, {1, 0}}.
+        SquareMatrix<2, double> tiny = {{1e-20, 1.0}, {1.0, 1.0}};
+        SquareMatrix<2, double> product = tiny * tiny.inverted();
+        for (size_t i = 0; i < 2; ++i) {
+            for (size_t j = 0; j < 2; ++j) {
+                assert(std::abs(product[i][j] - (i == j ? 1 : 0)) < 1e-12);
+            }
+        }
+        assert(std::abs(tiny.det() + 1) < 1e-12);
+        auto g = sampleMatrix<24, 24, double>(36);
+        for (size_t i = 0; i < 24; ++i) {
+            g[i][i] += 100;
+        }
+        SquareMatrix<24, double> residual = g * g.inverted();
+        residual -= identity<24, double>();
+        for (size_t i = 0; i < 24; ++i) {
+            for (size_t j = 0; j < 24; ++j) {
+                assert(std::abs(residual[i][j]) < 1e-12);
+            }
+        }
+    }
+    simdLevel() = detected;
+}
+
+template <typename Field>
+Polynomial<Field> samplePolynomial(size_t size, int seed) {
+    std::vector<Field> coefficients(size);
+    for (size_t i = 0; i < size; ++i) {
+        coefficients[i] =
+            Field(static_cast<int>((i * 7919 + 13) * (seed + 5) % 1009) - 500);
+    }
+    coefficients.back() = Field(seed);
+    return Polynomial<Field>(coefficients);
+}
+
+void testPolynomial() {
+    using F = Residue<998244353>;
+    static_assert(nttLimit<F> == (size_t(1) << 23));
+    static_assert(nttLimit<Residue<1000000007>> == 2);
+    assert(powMod(twoAdicRootOfUnity(998244353), 1 << 22, 998244353) ==
+           998244352);
+    auto a = samplePolynomial<F>(300, 1);
+    auto b = samplePolynomial<F>(170, 2);
+    std::vector<F> expected(469, F(0));
+    for (size_t i = 0; i < 300; ++i) {
+        for (size_t j = 0; j < 170; ++j) {
+            expected[i + j] += a[i] * b[j];
+        }
+    }
+    Polynomial<F> product = a * b;
+    assert(product.coefficients() == expected && product.degree() == 468);
+    Polynomial<F> inverse_series = a.inverseSeries(200);
+    assert((a * inverse_series).coefficients().size() > 200);
+    for (size_t i = 0; i < 200; ++i) {
+        assert((a * inverse_series)[i] == F(i == 0 ? 1 : 0));
+    }
+    auto c = samplePolynomial<F>(1000, 3);
+    auto [quotient, remainder] = c.divide(b);
+    assert(quotient.degree() == 830 && remainder.degree() < 169);
+    assert(b * quotient + remainder == c);
+    assert(c / a * a + c % a == c);
+    std::vector<F> points(500);
+    for (size_t i = 0; i < points.size(); ++i) {
+        points[i] = F(static_cast<long long>(i * i + 3));
+    }
+    std::vector<F> values = c.evaluate(points);
+    for (size_t i = 0; i < points.size(); ++i) {
+        assert(values[i] == c(points[i]));
+    }
+    using G = Residue<1000000007>;
+    auto d = samplePolynomial<G>(90, 4);
+    auto e = samplePolynomial<G>(40, 5);
+    assert((d * e) / e == d && (d * e + e) % d == e);
+    Polynomial<Rational> f = {1, -3, 0, 2};
+    Polynomial<Rational> g = {Rational(1) / Rational(2), Rational(1)};
+    auto [rational_quotient, rational_remainder] = f.divide(g);
+    assert(rational_remainder.degree() == 0);
+    assert(rational_remainder[0] == f(Rational(-1) / Rational(2)));
+    assert(g * rational_quotient + rational_remainder == f);
+    assert((Polynomial<Rational>{1, 1} * Polynomial<Rational>{-1, 1} ==
+            Polynomial<Rational>{-1, 0, 1}));
+    assert((f - f).isZero() && (f - f).degree() == -1);
+}
+
+template <size_t N, typename Field>
+SquareMatrix<N, Field> evaluateAt(const Polynomial<Field>& polynomial,
+                                  const SquareMatrix<N, Field>& a) {
+    SquareMatrix<N, Field> value;
+    for (size_t i = polynomial.coefficients().size(); i > 0; --i) {
+        value = value * a + polynomial[i - 1] * identity<N, Field>();
+    }
+    return value;
+}
+
+void testCharpoly() {
+    using F = Residue<1000000007>;
+    auto a = sampleMatrix<9, 9, F>(37);
+    a[0][0] += F(1);
+    auto h = hessenberg(a);
+    for (size_t i = 2; i < 9; ++i) {
+        for (size_t j = 0; j + 1 < i; ++j) {
+            assert(h[i][j] == F(0));
+        }
+    }
+    assert(h.trace() == a.trace() && h.det() == a.det());
+    Polynomial<F> p = charpoly(a);
+    assert(p.degree() == 9 && p[9] == F(1));
+    for (int t = -3; t <= 3; ++t) {
+        assert(p(F(t)) == (F(t) * identity<9, F>() - a).eval().det());
+    }
+    assert(evaluateAt(p, a) == (SquareMatrix<9, F>()));
+    assert(minpoly(a) == p);
+    auto b = sampleMatrix<5, 5, Rational>(38);
+    b[2][1] = Rational(1) / Rational(3);
+    Polynomial<Rational> q = charpoly(b);
+    assert(q[0] == -b.det() && q[4] == -b.trace());
+    assert(evaluateAt(q, b) == (SquareMatrix<5, Rational>()));
+    // diag(2, 2, 3, 3, 3) in another basis: (x - 2)^2 (x - 3)^3 is the
+    // characteristic polynomial, (x - 2)(x - 3) the minimal one.
+    SquareMatrix<5> basis = identity<5, Rational>();
+    for (size_t i = 0; i < 5; ++i) {
+        for (size_t j = i + 1; j < 5; ++j) {
+            basis[i][j] = Rational(static_cast<int>(i + 2 * j) % 3);
+        }
+    }
+    SquareMatrix<5> diagonal;
+    for (size_t i = 0; i < 5; ++i) {
+        diagonal[i][i] = Rational(i < 2 ? 2 : 3);
+    }
+    SquareMatrix<5> c = basis * diagonal * basis.inverted();
+    Polynomial<Rational> linear_2 = {-2, 1};
+    Polynomial<Rational> linear_3 = {-3, 1};
+    assert(charpoly(c) == linear_2 * linear_2 * linear_3 * linear_3 *
+                              linear_3);
+    assert(minpoly(c) == linear_2 * linear_3);
+    SquareMatrix<4, F> nilpotent;
+    for (size_t i = 0; i + 1 < 4; ++i) {
+        nilpotent[i][i + 1] = F(1);
+    }
+    assert(minpoly(nilpotent) == (Polynomial<F>{0, 0, 0, 0, 1}));
+    assert(minpoly(identity<4, F>()) == (Polynomial<F>{-1, 1}));
+    SquareMatrix<3, double> d = {{2.0, 1.0, 0.0}, {1.0, 3.0, 1.0},
+                                 {0.0, 1.0, 4.0}};
+    Polynomial<double> r = charpoly(d);
+    assert(std::abs(r(2.0) - (2.0 * identity<3, double>() - d).eval().det()) <
+           1e-9);
+}
+
+void testMatrixBatch() {
+    const size_t count = 37;
+    MatrixBatch<4, 4, Rational> a(count);
+    MatrixBatch<4, 4, Rational> b(count);
+    for (size_t k = 0; k < count; ++k) {
+        auto matrix = sampleMatrix<4, 4, Rational>(static_cast<int>(k));
+        for (size_t i = 0; i < 4; ++i) {
+            matrix[i][i] += Rational(static_cast<int>(50 + k));
+        }
+        a.set(k, matrix);
+        b.set(k, sampleMatrix<4, 4, Rational>(static_cast<int>(k + 1)));
+    }
+    auto product = a * b;
+    std::vector<Rational> det = a.det();
+    auto inverse = a.inverted();
+    for (size_t k = 0; k < count; ++k) {
+        assert(product.get(k) == a.get(k) * b.get(k));
+        assert(det[k] == a.get(k).det());
+        assert(inverse.get(k) == a.get(k).inverted());
+    }
+    // Above MAX_MINOR_SIZE det and inverted go matrix by matrix.
+    MatrixBatch<5, 5, Rational> large(3);
+    for (size_t k = 0; k < large.size(); ++k) {
+        auto matrix = sampleMatrix<5, 5, Rational>(static_cast<int>(k));
+        for (size_t i = 0; i < 5; ++i) {
+            matrix[i][i] += Rational(60);
+        }
+        large.set(k, matrix);
+    }
+    std::vector<Rational> large_det = large.det();
+    auto large_inverse = large.inverted();
+    for (size_t k = 0; k < large.size(); ++k) {
+        assert(large_det[k] == large.get(k).det());
+        assert(large_inverse.get(k) * large.get(k) ==
+               (identity<5, Rational>()));
+    }
+    SimdLevel detected = detectSimdLevel();
+    for (SimdLevel level :
+         {SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        simdLevel() = level;
+        MatrixBatch<3, 3, double> c(count);
+        for (size_t k = 0; k < count; ++k) {
+            auto matrix = sampleMatrix<3, 3, double>(static_cast<int>(k));
+            for (size_t i = 0; i < 3; ++i) {
+                matrix[i][i] += static_cast<double>(40 + k);
+            }
+            c.set(k, matrix);
+        }
+        // A rotation by a right angle: zero pivots need no special case.
+        c.set(0, {{0.0, -1.0, 0.0}, {1.0, 0.0, 0.0}, {0.0, 0.0, 1.0}});
+        assert(c.inverted().get(0) == c.get(0).transposed());
+        std::vector<double> c_det = c.det();
+        auto residual = c * c.inverted();
+        for (size_t k = 0; k < count; ++k) {
+            assert(std::abs(c_det[k] - c.get(k).det()) <
+                   1e-9 * std::abs(c_det[k]));
+            for (size_t i = 0; i < 3; ++i) {
+                for (size_t j = 0; j < 3; ++j) {
+                    assert(std::abs(residual.get(k)[i][j] - (i == j ? 1 : 0)) <
+                           1e-12);
+                }
+            }
+        }
+    }
+    simdLevel() = detected;
+}
 
 int main() {
-    // Add some tests here if you want to
+    testBigIntegerVector();
+    std::cerr << "Test BigIntegerVector passed." << std::endl;
+    testRationalCompare();
+    std::cerr << "Test Rational comparison passed." << std::endl;
+    testReduction();
+    std::cerr << "Test reduction passed." << std::endl;
+    testCRT();
+    std::cerr << "Test CRT passed." << std::endl;
+    testBitwise();
+    std::cerr << "Test bitwise passed." << std::endl;
+    testLimbAllocator();
+    std::cerr << "Test limb allocator passed." << std::endl;
+    testMatrixMultiply();
+    std::cerr << "Test matrix multiplication passed." << std::endl;
+    testStrassen();
+    std::cerr << "Test Strassen multiplication passed." << std::endl;
+    testResidue();
+    std::cerr << "Test Residue passed." << std::endl;
+    testPrimality();
+    std::cerr << "Test primality passed." << std::endl;
+    testElimination();
+    std::cerr << "Test elimination passed." << std::endl;
+    testFractionFree();
+    std::cerr << "Test fraction-free elimination passed." << std::endl;
+    testMultimodular();
+    std::cerr << "Test multi-modular elimination passed." << std::endl;
+    testDynamicMatrix();
+    std::cerr << "Test DynamicMatrix passed." << std::endl;
+    testParallel();
+    std::cerr << "Test parallel elimination passed." << std::endl;
+    testExpressions();
+    std::cerr << "Test expression templates passed." << std::endl;
+    testLUDecomposition();
+    std::cerr << "Test LU decomposition passed." << std::endl;
+    testSparseMatrix();
+    std::cerr << "Test sparse matrix passed." << std::endl;
+    testMatrixPower();
+    std::cerr << "Test matrix power passed." << std::endl;
+    testViews();
+    std::cerr << "Test matrix views passed." << std::endl;
+    testRowOrder();
+    std::cerr << "Test row order passed." << std::endl;
+    testSimd();
+    std::cerr << "Test SIMD kernels passed." << std::endl;
+    testPolynomial();
+    std::cerr << "Test polynomials passed." << std::endl;
+    testCharpoly();
+    std::cerr << "Test characteristic polynomial passed." << std::endl;
+    testMatrixBatch();
+    std::cerr << "Test matrix batch passed." << std::endl;
     return 0;
 }
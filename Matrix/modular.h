@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+
+constexpr uint64_t mulMod(uint64_t a, uint64_t b, uint64_t modulus) {
+    return static_cast<uint64_t>(static_cast<unsigned __int128>(a) * b %
+                                 modulus);
+}
+
+constexpr uint64_t powMod(uint64_t base, uint64_t exponent,
+                          uint64_t modulus) {
+    uint64_t result = 1 % modulus;
+    base %= modulus;
+    while (exponent != 0) {
+        if ((exponent & 1) != 0) {
+            result = mulMod(result, base, modulus);
+        }
+        exponent >>= 1;
+        base = mulMod(base, base, modulus);
+    }
+    return result;
+}
+
+// Inverse by the extended Euclidean algorithm; value and modulus must be
+// coprime.
+constexpr uint64_t inverseMod(uint64_t value, uint64_t modulus) {
+    int64_t old_r = static_cast<int64_t>(value % modulus);
+    int64_t r = static_cast<int64_t>(modulus);
+    int64_t old_s = 1;
+    int64_t s = 0;
+    while (r != 0) {
+        int64_t q = old_r / r;
+        int64_t temp = old_r - q * r;
+        old_r = r;
+        r = temp;
+        temp = old_s - q * s;
+        old_s = s;
+        s = temp;
+    }
+    return old_s < 0 ? static_cast<uint64_t>(old_s) + modulus
+                     : static_cast<uint64_t>(old_s);
+}
+
+// Inverse of an odd value modulo 2^64 by Newton iteration; each step doubles
+// the number of correct low bits.
+constexpr uint64_t inverseModWord(uint64_t odd) {
+    uint64_t inverse = odd;
+    for (int i = 0; i < 6; ++i) {
+        inverse *= 2 - odd * inverse;
+    }
+    return inverse;
+}
+
+// Deterministic Miller-Rabin: the first twelve primes as bases are exact for
+// every 64-bit input.
+constexpr bool isPrimeNumber(uint64_t n) {
+    if (n < 2) {
+        return false;
+    }
+    constexpr uint64_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    for (uint64_t base : bases) {
+        if (n % base == 0) {
+            return n == base;
+        }
+    }
+    uint64_t odd = n - 1;
+    int twos = 0;
+    while (odd % 2 == 0) {
+        odd /= 2;
+        ++twos;
+    }
+    for (uint64_t base : bases) {
+        uint64_t x = powMod(base, odd, n);
+        if (x == 1 || x == n - 1) {
+            continue;
+        }
+        bool composite = true;
+        for (int i = 1; i < twos && composite; ++i) {
+            x = mulMod(x, x, n);
+            composite = x != n - 1;
+        }
+        if (composite) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Exponent of the largest power of two dividing n - 1.
+constexpr int twoAdicity(uint64_t n) {
+    int twos = 0;
+    for (uint64_t odd = n - 1; odd % 2 == 0 && odd != 0; odd /= 2) {
+        ++twos;
+    }
+    return twos;
+}
+
+// A primitive 2^twoAdicity(prime)-th root of unity: g^((prime - 1) / 2^k)
+// for the least quadratic non-residue g, whose order has the full power of
+// two. These are the roots of a number-theoretic transform modulo prime.
+constexpr uint64_t twoAdicRootOfUnity(uint64_t prime) {
+    uint64_t generator = 2;
+    while (powMod(generator, (prime - 1) / 2, prime) != prime - 1) {
+        ++generator;
+    }
+    return powMod(generator, (prime - 1) >> twoAdicity(prime), prime);
+}
@@ -0,0 +1,236 @@
+#include "multimodular.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "crt.h"
+#include "modular.h"
+#include "thread_pool.h"
+
+namespace {
+
+const size_t PRIME_BITS = 61;
+const size_t RANK_PRIMES = 3;
+
+// Distinct primes just below 2^62, so each contributes at least 61 bits:
+// the count after the first skip. They are searched for once and the list
+// is only extended when more are needed.
+std::vector<long long> largePrimes(size_t count, size_t skip = 0) {
+    static std::mutex mutex;
+    static std::vector<long long> primes;
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t candidate = primes.empty()
+                             ? (1ULL << 62) - 1
+                             : static_cast<uint64_t>(primes.back()) - 2;
+    while (primes.size() < skip + count) {
+        if (isPrimeNumber(candidate)) {
+            primes.push_back(static_cast<long long>(candidate));
+        }
+        candidate -= 2;
+    }
+    return std::vector<long long>(primes.begin() + skip,
+                                  primes.begin() + skip + count);
+}
+
+std::vector<uint64_t> reduceEntries(const std::vector<BigInteger>& a,
+                                    long long prime) {
+    std::vector<uint64_t> result(a.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        result[i] = static_cast<uint64_t>(a[i].remainder(prime));
+    }
+    return result;
+}
+
+struct ModularElimination {
+    size_t rank;
+    uint64_t det;
+};
+
+// Elimination modulo p over the first pivot_columns columns of a rows x
+// columns matrix; det is the product of the pivots with the swap sign,
+// meaningful when the pivot block is square. Forward elimination suffices
+// for det and rank; with reduced (for solving) pivot rows are also scaled
+// to 1 and cleared above, i.e. Gauss-Jordan.
+ModularElimination eliminate(std::vector<uint64_t>& a, size_t rows,
+                             size_t columns, size_t pivot_columns, uint64_t p,
+                             bool reduced) {
+    ModularElimination result{0, 1};
+    for (size_t c = 0; c < pivot_columns && result.rank < rows; ++c) {
+        size_t r = result.rank;
+        size_t pivot = r;
+        while (pivot < rows && a[pivot * columns + c] == 0) {
+            ++pivot;
+        }
+        if (pivot == rows) {
+            result.det = 0;
+            continue;
+        }
+        if (pivot != r) {
+            for (size_t j = 0; j < columns; ++j) {
+                std::swap(a[pivot * columns + j], a[r * columns + j]);
+            }
+            result.det = p - result.det;
+        }
+        uint64_t pivot_value = a[r * columns + c];
+        result.det = mulMod(result.det, pivot_value, p);
+        uint64_t pivot_inverse = inverseMod(pivot_value, p);
+        if (reduced) {
+            for (size_t j = c; j < columns; ++j) {
+                a[r * columns + j] =
+                    mulMod(a[r * columns + j], pivot_inverse, p);
+            }
+        }
+        for (size_t i = reduced ? 0 : r + 1; i < rows; ++i) {
+            uint64_t factor = a[i * columns + c];
+            if (i == r || factor == 0) {
+                continue;
+            }
+            if (!reduced) {
+                factor = mulMod(factor, pivot_inverse, p);
+            }
+            for (size_t j = c; j < columns; ++j) {
+                uint64_t product = mulMod(factor, a[r * columns + j], p);
+                uint64_t& cell = a[i * columns + j];
+                cell = cell >= product ? cell - product : cell + p - product;
+            }
+        }
+        ++result.rank;
+    }
+    return result;
+}
+
+size_t halfBitLength(const BigInteger& square) {
+    return (square.bitLength() + 1) / 2;
+}
+
+// Bits of the Hadamard bound prod_j ||column_j||, which bounds |det a| and,
+// multiplied by ||b||, every Cramer numerator det(a with column i = b).
+size_t hadamardBits(const std::vector<BigInteger>& a, size_t n) {
+    size_t bits = 0;
+    for (size_t j = 0; j < n; ++j) {
+        BigInteger square = 0;
+        for (size_t i = 0; i < n; ++i) {
+            square += a[i * n + j] * a[i * n + j];
+        }
+        bits += halfBitLength(square);
+    }
+    return bits;
+}
+
+// Called from a pool worker, the primes run serially rather than wait on
+// tasks queued behind the caller.
+template <typename Result, typename Task>
+std::vector<Result> forEachPrime(const std::vector<long long>& primes,
+                                 const Task& task) {
+    if (ThreadPool::insideWorker()) {
+        std::vector<Result> results;
+        for (long long prime : primes) {
+            results.push_back(task(prime));
+        }
+        return results;
+    }
+    std::vector<std::future<Result>> futures;
+    for (long long prime : primes) {
+        futures.push_back(ThreadPool::global().submit(
+            [prime, &task]() { return task(prime); }));
+    }
+    std::vector<Result> results;
+    for (std::future<Result>& future : futures) {
+        results.push_back(future.get());
+    }
+    return results;
+}
+
+}  // namespace
+
+BigInteger multimodularDet(const std::vector<BigInteger>& a, size_t n) {
+    std::vector<long long> primes =
+        largePrimes((hadamardBits(a, n) + 1) / PRIME_BITS + 1);
+    std::vector<long long> residues =
+        forEachPrime<long long>(primes, [&a, n](long long prime) {
+            std::vector<uint64_t> reduced = reduceEntries(a, prime);
+            return static_cast<long long>(
+                eliminate(reduced, n, n, n, static_cast<uint64_t>(prime),
+                          false)
+                    .det);
+        });
+    return CRT(primes).reconstructSigned(residues);
+}
+
+// The rank modulo p never exceeds the rank over Q and is equal for all but
+// the primes dividing one nonzero maximal minor, so a few 62-bit primes
+// agree with overwhelming probability.
+size_t multimodularRank(const std::vector<BigInteger>& a, size_t rows,
+                        size_t columns) {
+    std::vector<size_t> ranks = forEachPrime<size_t>(
+        largePrimes(RANK_PRIMES), [&a, rows, columns](long long prime) {
+            std::vector<uint64_t> reduced = reduceEntries(a, prime);
+            return eliminate(reduced, rows, columns, columns,
+                             static_cast<uint64_t>(prime), false)
+                .rank;
+        });
+    return *std::max_element(ranks.begin(), ranks.end());
+}
+
+std::optional<std::vector<BigInteger>> multimodularSolve(
+    const std::vector<BigInteger>& a, const std::vector<BigInteger>& b,
+    size_t n, BigInteger& denominator) {
+    denominator = multimodularDet(a, n);
+    if (denominator == 0) {
+        return std::nullopt;
+    }
+    BigInteger b_square = 0;
+    for (const BigInteger& value : b) {
+        b_square += value * value;
+    }
+    size_t needed =
+        (hadamardBits(a, n) + halfBitLength(b_square) + 1) / PRIME_BITS + 1;
+    std::vector<BigInteger> augmented(n * (n + 1));
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            augmented[i * (n + 1) + j] = a[i * n + j];
+        }
+        augmented[i * (n + 1) + n] = b[i];
+    }
+    // Each prime yields det * x mod p, i.e. the Cramer numerators; primes
+    // dividing the determinant are skipped.
+    auto task = [&augmented, n](long long prime) {
+        auto p = static_cast<uint64_t>(prime);
+        std::vector<uint64_t> reduced = reduceEntries(augmented, prime);
+        ModularElimination result = eliminate(reduced, n, n + 1, n, p, true);
+        std::vector<long long> numerators;
+        if (result.det != 0) {
+            for (size_t i = 0; i < n; ++i) {
+                numerators.push_back(static_cast<long long>(
+                    mulMod(reduced[i * (n + 1) + n], result.det, p)));
+            }
+        }
+        return numerators;
+    };
+    std::vector<long long> lucky_primes;
+    std::vector<std::vector<long long>> images;
+    size_t tried = 0;
+    while (lucky_primes.size() < needed) {
+        std::vector<long long> primes =
+            largePrimes(needed - lucky_primes.size(), tried);
+        tried += primes.size();
+        std::vector<std::vector<long long>> results =
+            forEachPrime<std::vector<long long>>(primes, task);
+        for (size_t i = 0; i < primes.size(); ++i) {
+            if (!results[i].empty()) {
+                lucky_primes.push_back(primes[i]);
+                images.push_back(std::move(results[i]));
+            }
+        }
+    }
+    CRT crt(lucky_primes);
+    std::vector<BigInteger> numerators(n);
+    std::vector<long long> residues(lucky_primes.size());
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t k = 0; k < lucky_primes.size(); ++k) {
+            residues[k] = images[k][i];
+        }
+        numerators[i] = crt.reconstructSigned(residues);
+    }
+    return numerators;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <optional>
+#include "matrix.h"
+
+// Exact linear algebra over the integers by elimination modulo independent
+// word-sized primes (solved in parallel on ThreadPool::global()) and CRT
+// reconstruction. Matrices are row-major; the number of primes follows from
+// the Hadamard bound of the input.
+BigInteger multimodularDet(const std::vector<BigInteger>& a, size_t n);
+size_t multimodularRank(const std::vector<BigInteger>& a, size_t rows,
+                        size_t columns);
+// Solves a x = b as x = y / denominator with integer y; std::nullopt if a is
+// singular.
+std::optional<std::vector<BigInteger>> multimodularSolve(
+    const std::vector<BigInteger>& a, const std::vector<BigInteger>& b,
+    size_t n, BigInteger& denominator);
+
+template <size_t M, size_t N>
+std::vector<BigInteger> multimodularIntegers(
+    const Matrix<M, N, Rational>& a, std::vector<BigInteger>& scales) {
+    std::vector<Rational> values;
+    values.reserve(M * N);
+    for (size_t i = 0; i < M; ++i) {
+        values.insert(values.end(), a[i].begin(), a[i].end());
+    }
+    return clearDenominators(values, M, N, scales);
+}
+
+template <size_t N>
+Rational multimodularDet(const SquareMatrix<N, Rational>& a) {
+    std::vector<BigInteger> scales;
+    std::vector<BigInteger> integers = multimodularIntegers(a, scales);
+    BigInteger denominator = 1;
+    for (const BigInteger& scale : scales) {
+        denominator *= scale;
+    }
+    return Rational(multimodularDet(integers, N)) / Rational(denominator);
+}
+
+template <size_t M, size_t N>
+size_t multimodularRank(const Matrix<M, N, Rational>& a) {
+    std::vector<BigInteger> scales;
+    return multimodularRank(multimodularIntegers(a, scales), M, N);
+}
+
+template <size_t N>
+std::optional<std::array<Rational, N>> multimodularSolve(
+    const SquareMatrix<N, Rational>& a, const std::array<Rational, N>& b) {
+    std::vector<BigInteger> scales;
+    std::vector<BigInteger> integers = multimodularIntegers(a, scales);
+    std::vector<Rational> scaled_b(N);
+    for (size_t i = 0; i < N; ++i) {
+        scaled_b[i] = b[i] * Rational(scales[i]);
+    }
+    std::vector<BigInteger> b_scale;
+    std::vector<BigInteger> b_integers =
+        clearDenominators(scaled_b, 1, N, b_scale);
+    BigInteger denominator;
+    std::optional<std::vector<BigInteger>> y =
+        multimodularSolve(integers, b_integers, N, denominator);
+    if (!y.has_value()) {
+        return std::nullopt;
+    }
+    std::array<Rational, N> x;
+    Rational common = Rational(denominator) * Rational(b_scale[0]);
+    for (size_t i = 0; i < N; ++i) {
+        x[i] = Rational((*y)[i]) / common;
+    }
+    return x;
+}
@@ -0,0 +1,437 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include "matrix.h"
+
+// Largest power-of-two transform length modulo Field, 0 if Field is not a
+// Residue modulo a prime.
+template <typename Field>
+constexpr size_t nttLimit = 0;
+
+template <size_t P>
+constexpr size_t nttLimit<Residue<P>> =
+    isPrime<P> ? size_t(1) << twoAdicity(P) : 0;
+
+// In-place number-theoretic transform of a power-of-two length of at most
+// nttLimit; the inverse transform includes the division by the length.
+template <size_t P>
+void ntt(std::vector<Residue<P>>& values, bool invert) {
+    size_t n = values.size();
+    assert((n & (n - 1)) == 0 && n <= nttLimit<Residue<P>>);
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; (j & bit) != 0; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(values[i], values[j]);
+        }
+    }
+    constexpr uint64_t ROOT = twoAdicRootOfUnity(P);
+    std::vector<Residue<P>> twiddles(n / 2);
+    for (size_t length = 2; length <= n; length <<= 1) {
+        Residue<P> step(static_cast<long long>(ROOT));
+        for (size_t order = length; order < nttLimit<Residue<P>>;
+             order <<= 1) {
+            step *= step;
+        }
+        if (invert) {
+            step = step.inverse();
+        }
+        size_t half = length / 2;
+        twiddles[0] = Residue<P>(1);
+        for (size_t j = 1; j < half; ++j) {
+            twiddles[j] = twiddles[j - 1] * step;
+        }
+        for (size_t i = 0; i < n; i += length) {
+            for (size_t j = 0; j < half; ++j) {
+                Residue<P> u = values[i + j];
+                Residue<P> v = values[i + j + half] * twiddles[j];
+                values[i + j] = u + v;
+                values[i + j + half] = u - v;
+            }
+        }
+    }
+    if (invert) {
+        Residue<P> scale =
+            Residue<P>(static_cast<long long>(n % P)).inverse();
+        for (Residue<P>& value : values) {
+            value *= scale;
+        }
+    }
+}
+
+// Polynomial with coefficients in Field, lowest degree first and without
+// trailing zeros. Long products modulo an NTT-friendly prime (nttLimit > 0)
+// take O(n log n) through ntt; inverseSeries, divide and evaluate are built
+// on products, so they get O(n log n) and O(n log^2 n) there too. Every
+// operation also works over other fields with schoolbook products.
+template <typename Field>
+class Polynomial {
+  public:
+    Polynomial() = default;
+    explicit Polynomial(std::vector<Field> coefficients);
+    template <typename T>
+    Polynomial(const std::initializer_list<T>& coefficients);
+    // -1 for the zero polynomial.
+    int degree() const;
+    bool isZero() const;
+    const std::vector<Field>& coefficients() const;
+    Field operator[](size_t index) const;
+    Field operator()(const Field& x) const;
+    Polynomial& operator+=(const Polynomial& other);
+    Polynomial& operator-=(const Polynomial& other);
+    Polynomial& operator*=(const Polynomial& other);
+    Polynomial& operator*=(const Field& scale);
+    // Scaled to leading coefficient 1; zero stays zero.
+    Polynomial monic() const;
+    // g with f g = 1 mod x^precision, by Newton's iteration
+    // g <- g (2 - f g), which doubles the precision each step.
+    Polynomial inverseSeries(size_t precision) const;
+    // Quotient and remainder with deg remainder < deg divisor.
+    std::pair<Polynomial, Polynomial> divide(const Polynomial& divisor) const;
+    // Values at every point, by reducing modulo the subproduct tree of
+    // (x - point) factors.
+    std::vector<Field> evaluate(const std::vector<Field>& points) const;
+    static std::vector<Field> multiply(const std::vector<Field>& a,
+                                       const std::vector<Field>& b);
+
+  private:
+    static constexpr size_t NAIVE_LIMIT_ = 32;
+    void normalize();
+    Polynomial truncated(size_t size) const;
+    Polynomial reversed(size_t size) const;
+    static void buildTree(std::vector<Polynomial>& tree,
+                          const std::vector<Field>& points, size_t node,
+                          size_t begin, size_t end);
+    static void evaluateTree(const std::vector<Polynomial>& tree,
+                             const std::vector<Field>& points,
+                             const Polynomial& remainder, size_t node,
+                             size_t begin, size_t end,
+                             std::vector<Field>& values);
+    std::vector<Field> coefficients_;
+};
+
+template <typename Field>
+Polynomial<Field>::Polynomial(std::vector<Field> coefficients)
+    : coefficients_(std::move(coefficients)) {
+    normalize();
+}
+
+template <typename Field>
+template <typename T>
+Polynomial<Field>::Polynomial(const std::initializer_list<T>& coefficients) {
+    for (const T& coefficient : coefficients) {
+        coefficients_.push_back(Field(coefficient));
+    }
+    normalize();
+}
+
+template <typename Field>
+void Polynomial<Field>::normalize() {
+    while (!coefficients_.empty() && coefficients_.back() == Field(0)) {
+        coefficients_.pop_back();
+    }
+}
+
+template <typename Field>
+int Polynomial<Field>::degree() const {
+    return static_cast<int>(coefficients_.size()) - 1;
+}
+
+template <typename Field>
+bool Polynomial<Field>::isZero() const {
+    return coefficients_.empty();
+}
+
+template <typename Field>
+const std::vector<Field>& Polynomial<Field>::coefficients() const {
+    return coefficients_;
+}
+
+template <typename Field>
+Field Polynomial<Field>::operator[](size_t index) const {
+    return index < coefficients_.size() ? coefficients_[index] : Field(0);
+}
+
+template <typename Field>
+Field Polynomial<Field>::operator()(const Field& x) const {
+    Field value(0);
+    for (size_t i = coefficients_.size(); i > 0; --i) {
+        value = value * x + coefficients_[i - 1];
+    }
+    return value;
+}
+
+template <typename Field>
+Polynomial<Field>& Polynomial<Field>::operator+=(const Polynomial& other) {
+    if (coefficients_.size() < other.coefficients_.size()) {
+        coefficients_.resize(other.coefficients_.size(), Field(0));
+    }
+    for (size_t i = 0; i < other.coefficients_.size(); ++i) {
+        coefficients_[i] += other.coefficients_[i];
+    }
+    normalize();
+    return *this;
+}
+
+template <typename Field>
+Polynomial<Field>& Polynomial<Field>::operator-=(const Polynomial& other) {
+    if (coefficients_.size() < other.coefficients_.size()) {
+        coefficients_.resize(other.coefficients_.size(), Field(0));
+    }
+    for (size_t i = 0; i < other.coefficients_.size(); ++i) {
+        coefficients_[i] -= other.coefficients_[i];
+    }
+    normalize();
+    return *this;
+}
+
+template <typename Field>
+Polynomial<Field>& Polynomial<Field>::operator*=(const Polynomial& other) {
+    coefficients_ = multiply(coefficients_, other.coefficients_);
+    normalize();
+    return *this;
+}
+
+template <typename Field>
+Polynomial<Field>& Polynomial<Field>::operator*=(const Field& scale) {
+    for (Field& coefficient : coefficients_) {
+        coefficient *= scale;
+    }
+    normalize();
+    return *this;
+}
+
+template <typename Field>
+Polynomial<Field> Polynomial<Field>::monic() const {
+    if (isZero()) {
+        return *this;
+    }
+    Polynomial copy = *this;
+    copy *= inverse(coefficients_.back());
+    return copy;
+}
+
+// Schoolbook below NAIVE_LIMIT_ coefficients in the shorter factor, cyclic
+// convolution by ntt of the next power of two above that.
+template <typename Field>
+std::vector<Field> Polynomial<Field>::multiply(const std::vector<Field>& a,
+                                               const std::vector<Field>& b) {
+    if (a.empty() || b.empty()) {
+        return {};
+    }
+    size_t size = a.size() + b.size() - 1;
+    if constexpr (nttLimit<Field> > 0) {
+        size_t length = 1;
+        while (length < size) {
+            length <<= 1;
+        }
+        if (std::min(a.size(), b.size()) > NAIVE_LIMIT_ &&
+            length <= nttLimit<Field>) {
+            std::vector<Field> a_values(a);
+            std::vector<Field> b_values(b);
+            a_values.resize(length, Field(0));
+            b_values.resize(length, Field(0));
+            ntt(a_values, false);
+            ntt(b_values, false);
+            for (size_t i = 0; i < length; ++i) {
+                a_values[i] *= b_values[i];
+            }
+            ntt(a_values, true);
+            a_values.resize(size);
+            return a_values;
+        }
+    }
+    std::vector<Field> product(size, Field(0));
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t j = 0; j < b.size(); ++j) {
+            product[i + j] += a[i] * b[j];
+        }
+    }
+    return product;
+}
+
+template <typename Field>
+Polynomial<Field> Polynomial<Field>::truncated(size_t size) const {
+    size = std::min(size, coefficients_.size());
+    return Polynomial(std::vector<Field>(coefficients_.begin(),
+                                         coefficients_.begin() + size));
+}
+
+// x^(size - 1) f(1 / x) for size > deg f.
+template <typename Field>
+Polynomial<Field> Polynomial<Field>::reversed(size_t size) const {
+    std::vector<Field> coefficients(size, Field(0));
+    for (size_t i = 0; i < coefficients_.size(); ++i) {
+        coefficients[size - 1 - i] = coefficients_[i];
+    }
+    return Polynomial(std::move(coefficients));
+}
+
+template <typename Field>
+Polynomial<Field> Polynomial<Field>::inverseSeries(size_t precision) const {
+    assert(!isZero() && coefficients_[0] != Field(0));
+    Polynomial inverse_series{inverse(coefficients_[0])};
+    for (size_t length = 1; length < precision;) {
+        length *= 2;
+        Polynomial correction = (truncated(length) * inverse_series)
+                                    .truncated(length);
+        correction *= Field(-1);
+        correction += Polynomial{Field(2)};
+        inverse_series = (inverse_series * correction).truncated(length);
+    }
+    return inverse_series.truncated(precision);
+}
+
+// Short quotients by long division; otherwise the reversed quotient is
+// rev(a) / rev(b) mod x^(deg a - deg b + 1), a product with inverseSeries.
+template <typename Field>
+std::pair<Polynomial<Field>, Polynomial<Field>> Polynomial<Field>::divide(
+    const Polynomial& divisor) const {
+    assert(!divisor.isZero());
+    if (degree() < divisor.degree()) {
+        return {Polynomial(), *this};
+    }
+    size_t n = coefficients_.size();
+    size_t m = divisor.coefficients_.size();
+    size_t quotient_size = n - m + 1;
+    if (std::min(quotient_size, m) <= NAIVE_LIMIT_) {
+        std::vector<Field> remainder = coefficients_;
+        std::vector<Field> quotient(quotient_size);
+        Field lead_inverse = inverse(divisor.coefficients_.back());
+        for (size_t i = quotient_size; i > 0; --i) {
+            Field factor = remainder[i - 1 + m - 1] * lead_inverse;
+            quotient[i - 1] = factor;
+            for (size_t j = 0; j < m; ++j) {
+                remainder[i - 1 + j] -= factor * divisor.coefficients_[j];
+            }
+        }
+        remainder.resize(m - 1);
+        return {Polynomial(std::move(quotient)),
+                Polynomial(std::move(remainder))};
+    }
+    Polynomial quotient =
+        (reversed(n).truncated(quotient_size) *
+         divisor.reversed(m).inverseSeries(quotient_size))
+            .truncated(quotient_size)
+            .reversed(quotient_size);
+    Polynomial remainder = *this;
+    remainder -= divisor * quotient;
+    return {quotient, remainder};
+}
+
+template <typename Field>
+void Polynomial<Field>::buildTree(std::vector<Polynomial>& tree,
+                                  const std::vector<Field>& points,
+                                  size_t node, size_t begin, size_t end) {
+    if (end - begin == 1) {
+        tree[node] = Polynomial{Field(0) - points[begin], Field(1)};
+        return;
+    }
+    size_t middle = begin + (end - begin) / 2;
+    buildTree(tree, points, 2 * node, begin, middle);
+    buildTree(tree, points, 2 * node + 1, middle, end);
+    tree[node] = tree[2 * node] * tree[2 * node + 1];
+}
+
+// remainder is the polynomial modulo the product of the (x - point) in
+// [begin, end), so it has the same values there; short ranges finish with
+// Horner's rule.
+template <typename Field>
+void Polynomial<Field>::evaluateTree(const std::vector<Polynomial>& tree,
+                                     const std::vector<Field>& points,
+                                     const Polynomial& remainder,
+                                     size_t node, size_t begin, size_t end,
+                                     std::vector<Field>& values) {
+    if (end - begin <= NAIVE_LIMIT_) {
+        for (size_t i = begin; i < end; ++i) {
+            values[i] = remainder(points[i]);
+        }
+        return;
+    }
+    size_t middle = begin + (end - begin) / 2;
+    evaluateTree(tree, points, remainder.divide(tree[2 * node]).second,
+                 2 * node, begin, middle, values);
+    evaluateTree(tree, points, remainder.divide(tree[2 * node + 1]).second,
+                 2 * node + 1, middle, end, values);
+}
+
+template <typename Field>
+std::vector<Field> Polynomial<Field>::evaluate(
+    const std::vector<Field>& points) const {
+    std::vector<Field> values(points.size());
+    if (points.size() <= NAIVE_LIMIT_ ||
+        coefficients_.size() <= NAIVE_LIMIT_) {
+        for (size_t i = 0; i < points.size(); ++i) {
+            values[i] = (*this)(points[i]);
+        }
+        return values;
+    }
+    std::vector<Polynomial> tree(4 * points.size());
+    buildTree(tree, points, 1, 0, points.size());
+    evaluateTree(tree, points, divide(tree[1]).second, 1, 0, points.size(),
+                 values);
+    return values;
+}
+
+template <typename Field>
+Polynomial<Field> operator+(const Polynomial<Field>& a,
+                            const Polynomial<Field>& b) {
+    Polynomial<Field> copy = a;
+    copy += b;
+    return copy;
+}
+
+template <typename Field>
+Polynomial<Field> operator-(const Polynomial<Field>& a,
+                            const Polynomial<Field>& b) {
+    Polynomial<Field> copy = a;
+    copy -= b;
+    return copy;
+}
+
+template <typename Field>
+Polynomial<Field> operator*(const Polynomial<Field>& a,
+                            const Polynomial<Field>& b) {
+    return Polynomial<Field>(
+        Polynomial<Field>::multiply(a.coefficients(), b.coefficients()));
+}
+
+template <typename Field>
+Polynomial<Field> operator/(const Polynomial<Field>& a,
+                            const Polynomial<Field>& b) {
+    return a.divide(b).first;
+}
+
+template <typename Field>
+Polynomial<Field> operator%(const Polynomial<Field>& a,
+                            const Polynomial<Field>& b) {
+    return a.divide(b).second;
+}
+
+template <typename Field>
+bool operator==(const Polynomial<Field>& a, const Polynomial<Field>& b) {
+    return a.coefficients() == b.coefficients();
+}
+
+// Monic greatest common divisor by Euclid's algorithm.
+template <typename Field>
+Polynomial<Field> gcd(Polynomial<Field> a, Polynomial<Field> b) {
+    while (!b.isZero()) {
+        a = a % b;
+        std::swap(a, b);
+    }
+    return a.monic();
+}
+
+template <typename Field>
+Polynomial<Field> lcm(const Polynomial<Field>& a, const Polynomial<Field>& b) {
+    if (a.isZero() || b.isZero()) {
+        return Polynomial<Field>();
+    }
+    return (a / gcd(a, b) * b).monic();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include "thread_pool.h"
+
+const size_t MIN_REDUCTION_CHUNK = 64;
+
+template <typename T, typename Leaf, typename Combine>
+T treeReduce(size_t begin, size_t end, const T& identity, const Leaf& leaf,
+             const Combine& combine) {
+    if (begin == end) {
+        return identity;
+    }
+    if (begin + 1 == end) {
+        return leaf(begin);
+    }
+    size_t middle = begin + (end - begin) / 2;
+    return combine(treeReduce(begin, middle, identity, leaf, combine),
+                   treeReduce(middle, end, identity, leaf, combine));
+}
+
+// Like ThreadPool::parallelFor, a reduction called from a worker runs
+// serially instead of blocking on chunks queued behind it.
+template <typename T, typename Leaf, typename Combine>
+T parallelReduce(size_t size, const T& identity, const Leaf& leaf,
+                 const Combine& combine, ThreadPool& pool) {
+    size_t chunks = std::min(pool.size(), size / MIN_REDUCTION_CHUNK);
+    if (chunks <= 1 || ThreadPool::insideWorker()) {
+        return treeReduce(0, size, identity, leaf, combine);
+    }
+    std::vector<std::future<T>> futures;
+    for (size_t i = 0; i < chunks; ++i) {
+        size_t begin = size * i / chunks;
+        size_t end = size * (i + 1) / chunks;
+        futures.push_back(
+            pool.submit([begin, end, &identity, &leaf, &combine]() {
+                return treeReduce(begin, end, identity, leaf, combine);
+            }));
+    }
+    std::vector<T> partial;
+    for (std::future<T>& future : futures) {
+        partial.push_back(future.get());
+    }
+    return treeReduce(
+        0, chunks, identity, [&partial](size_t i) { return partial[i]; },
+        combine);
+}
+
+template <typename Iterator>
+std::iter_value_t<Iterator> sum(Iterator first, Iterator last,
+                                ThreadPool& pool = ThreadPool::global()) {
+    using T = std::iter_value_t<Iterator>;
+    return parallelReduce(
+        static_cast<size_t>(last - first), T(0),
+        [first](size_t i) { return T(first[i]); },
+        [](const T& a, const T& b) { return a + b; }, pool);
+}
+
+template <typename Iterator>
+std::iter_value_t<Iterator> product(Iterator first, Iterator last,
+                                    ThreadPool& pool = ThreadPool::global()) {
+    using T = std::iter_value_t<Iterator>;
+    return parallelReduce(
+        static_cast<size_t>(last - first), T(1),
+        [first](size_t i) { return T(first[i]); },
+        [](const T& a, const T& b) { return a * b; }, pool);
+}
+
+template <typename Iterator1, typename Iterator2>
+std::iter_value_t<Iterator1> dot(Iterator1 first1, Iterator1 last1,
+                                 Iterator2 first2,
+                                 ThreadPool& pool = ThreadPool::global()) {
+    using T = std::iter_value_t<Iterator1>;
+    return parallelReduce(
+        static_cast<size_t>(last1 - first1), T(0),
+        [first1, first2](size_t i) { return T(first1[i]) * first2[i]; },
+        [](const T& a, const T& b) { return a + b; }, pool);
+}
@@ -0,0 +1,386 @@
+#include "simd.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MATRIX_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+template <typename T>
+void axpyScalar(T* y, const T* x, T a, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        y[i] += a * x[i];
+    }
+}
+
+template <typename T>
+void scaleScalar(T* y, T a, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        y[i] *= a;
+    }
+}
+
+template <typename T>
+T dotScalar(const T* x, const T* y, size_t n) {
+    T sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += x[i] * y[i];
+    }
+    return sum;
+}
+
+template <typename T>
+void multiplyAddScalar(T* z, const T* x, const T* y, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        z[i] += x[i] * y[i];
+    }
+}
+
+template <typename T>
+void multiplySubtractScalar(T* z, const T* x, const T* y, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        z[i] -= x[i] * y[i];
+    }
+}
+
+#ifdef MATRIX_X86_SIMD
+
+// Full vectors first, then a scalar tail.
+__attribute__((target("avx2,fma"))) void axpyAvx2(double* y, const double* x,
+                                                  double a, size_t n) {
+    __m256d factor = _mm256_set1_pd(a);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d sum = _mm256_fmadd_pd(factor, _mm256_loadu_pd(x + i),
+                                      _mm256_loadu_pd(y + i));
+        _mm256_storeu_pd(y + i, sum);
+    }
+    axpyScalar(y + i, x + i, a, n - i);
+}
+
+__attribute__((target("avx2,fma"))) void axpyAvx2(float* y, const float* x,
+                                                  float a, size_t n) {
+    __m256 factor = _mm256_set1_ps(a);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 sum = _mm256_fmadd_ps(factor, _mm256_loadu_ps(x + i),
+                                     _mm256_loadu_ps(y + i));
+        _mm256_storeu_ps(y + i, sum);
+    }
+    axpyScalar(y + i, x + i, a, n - i);
+}
+
+__attribute__((target("avx2"))) void scaleAvx2(double* y, double a,
+                                               size_t n) {
+    __m256d factor = _mm256_set1_pd(a);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(y + i, _mm256_mul_pd(factor, _mm256_loadu_pd(y + i)));
+    }
+    scaleScalar(y + i, a, n - i);
+}
+
+__attribute__((target("avx2"))) void scaleAvx2(float* y, float a, size_t n) {
+    __m256 factor = _mm256_set1_ps(a);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(y + i, _mm256_mul_ps(factor, _mm256_loadu_ps(y + i)));
+    }
+    scaleScalar(y + i, a, n - i);
+}
+
+__attribute__((target("avx2,fma"))) double dotAvx2(const double* x,
+                                                   const double* y, size_t n) {
+    __m256d sums = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        sums = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i),
+                               sums);
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, sums);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+           dotScalar(x + i, y + i, n - i);
+}
+
+__attribute__((target("avx2,fma"))) float dotAvx2(const float* x,
+                                                  const float* y, size_t n) {
+    __m256 sums = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        sums = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i),
+                               sums);
+    }
+    float lanes[8];
+    _mm256_storeu_ps(lanes, sums);
+    float sum = 0;
+    for (float lane : lanes) {
+        sum += lane;
+    }
+    return sum + dotScalar(x + i, y + i, n - i);
+}
+
+__attribute__((target("avx2,fma"))) void multiplyAddAvx2(double* z,
+                                                         const double* x,
+                                                         const double* y,
+                                                         size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d sum = _mm256_fmadd_pd(_mm256_loadu_pd(x + i),
+                                      _mm256_loadu_pd(y + i),
+                                      _mm256_loadu_pd(z + i));
+        _mm256_storeu_pd(z + i, sum);
+    }
+    multiplyAddScalar(z + i, x + i, y + i, n - i);
+}
+
+__attribute__((target("avx2,fma"))) void multiplyAddAvx2(float* z,
+                                                         const float* x,
+                                                         const float* y,
+                                                         size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 sum = _mm256_fmadd_ps(_mm256_loadu_ps(x + i),
+                                     _mm256_loadu_ps(y + i),
+                                     _mm256_loadu_ps(z + i));
+        _mm256_storeu_ps(z + i, sum);
+    }
+    multiplyAddScalar(z + i, x + i, y + i, n - i);
+}
+
+__attribute__((target("avx2,fma"))) void multiplySubtractAvx2(double* z,
+                                                              const double* x,
+                                                              const double* y,
+                                                              size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d difference = _mm256_fnmadd_pd(_mm256_loadu_pd(x + i),
+                                              _mm256_loadu_pd(y + i),
+                                              _mm256_loadu_pd(z + i));
+        _mm256_storeu_pd(z + i, difference);
+    }
+    multiplySubtractScalar(z + i, x + i, y + i, n - i);
+}
+
+__attribute__((target("avx2,fma"))) void multiplySubtractAvx2(float* z,
+                                                              const float* x,
+                                                              const float* y,
+                                                              size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 difference = _mm256_fnmadd_ps(_mm256_loadu_ps(x + i),
+                                             _mm256_loadu_ps(y + i),
+                                             _mm256_loadu_ps(z + i));
+        _mm256_storeu_ps(z + i, difference);
+    }
+    multiplySubtractScalar(z + i, x + i, y + i, n - i);
+}
+
+// The tail is one masked vector instead of a scalar loop.
+__attribute__((target("avx512f"))) void axpyAvx512(double* y, const double* x,
+                                                   double a, size_t n) {
+    __m512d factor = _mm512_set1_pd(a);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d sum = _mm512_fmadd_pd(factor, _mm512_loadu_pd(x + i),
+                                      _mm512_loadu_pd(y + i));
+        _mm512_storeu_pd(y + i, sum);
+    }
+    if (i < n) {
+        __mmask8 mask = (1U << (n - i)) - 1;
+        __m512d sum =
+            _mm512_fmadd_pd(factor, _mm512_maskz_loadu_pd(mask, x + i),
+                            _mm512_maskz_loadu_pd(mask, y + i));
+        _mm512_mask_storeu_pd(y + i, mask, sum);
+    }
+}
+
+__attribute__((target("avx512f"))) void axpyAvx512(float* y, const float* x,
+                                                   float a, size_t n) {
+    __m512 factor = _mm512_set1_ps(a);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 sum = _mm512_fmadd_ps(factor, _mm512_loadu_ps(x + i),
+                                     _mm512_loadu_ps(y + i));
+        _mm512_storeu_ps(y + i, sum);
+    }
+    if (i < n) {
+        __mmask16 mask = (1U << (n - i)) - 1;
+        __m512 sum =
+            _mm512_fmadd_ps(factor, _mm512_maskz_loadu_ps(mask, x + i),
+                            _mm512_maskz_loadu_ps(mask, y + i));
+        _mm512_mask_storeu_ps(y + i, mask, sum);
+    }
+}
+
+__attribute__((target("avx512f"))) void scaleAvx512(double* y, double a,
+                                                    size_t n) {
+    __m512d factor = _mm512_set1_pd(a);
+    for (size_t i = 0; i < n; i += 8) {
+        __mmask8 mask = n - i >= 8 ? 0xFF : (1U << (n - i)) - 1;
+        __m512d value = _mm512_maskz_loadu_pd(mask, y + i);
+        _mm512_mask_storeu_pd(y + i, mask, _mm512_mul_pd(factor, value));
+    }
+}
+
+__attribute__((target("avx512f"))) void scaleAvx512(float* y, float a,
+                                                    size_t n) {
+    __m512 factor = _mm512_set1_ps(a);
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 mask = n - i >= 16 ? 0xFFFF : (1U << (n - i)) - 1;
+        __m512 value = _mm512_maskz_loadu_ps(mask, y + i);
+        _mm512_mask_storeu_ps(y + i, mask, _mm512_mul_ps(factor, value));
+    }
+}
+
+__attribute__((target("avx512f"))) double dotAvx512(const double* x,
+                                                    const double* y,
+                                                    size_t n) {
+    __m512d sums = _mm512_setzero_pd();
+    for (size_t i = 0; i < n; i += 8) {
+        __mmask8 mask = n - i >= 8 ? 0xFF : (1U << (n - i)) - 1;
+        sums = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + i),
+                               _mm512_maskz_loadu_pd(mask, y + i), sums);
+    }
+    double lanes[8];
+    _mm512_storeu_pd(lanes, sums);
+    double sum = 0;
+    for (double lane : lanes) {
+        sum += lane;
+    }
+    return sum;
+}
+
+__attribute__((target("avx512f"))) float dotAvx512(const float* x,
+                                                   const float* y, size_t n) {
+    __m512 sums = _mm512_setzero_ps();
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 mask = n - i >= 16 ? 0xFFFF : (1U << (n - i)) - 1;
+        sums = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, x + i),
+                               _mm512_maskz_loadu_ps(mask, y + i), sums);
+    }
+    float lanes[16];
+    _mm512_storeu_ps(lanes, sums);
+    float sum = 0;
+    for (float lane : lanes) {
+        sum += lane;
+    }
+    return sum;
+}
+
+__attribute__((target("avx512f"))) void multiplyAddAvx512(double* z,
+                                                          const double* x,
+                                                          const double* y,
+                                                          size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d sum = _mm512_fmadd_pd(_mm512_loadu_pd(x + i),
+                                      _mm512_loadu_pd(y + i),
+                                      _mm512_loadu_pd(z + i));
+        _mm512_storeu_pd(z + i, sum);
+    }
+    multiplyAddScalar(z + i, x + i, y + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void multiplyAddAvx512(float* z,
+                                                          const float* x,
+                                                          const float* y,
+                                                          size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 sum = _mm512_fmadd_ps(_mm512_loadu_ps(x + i),
+                                     _mm512_loadu_ps(y + i),
+                                     _mm512_loadu_ps(z + i));
+        _mm512_storeu_ps(z + i, sum);
+    }
+    multiplyAddScalar(z + i, x + i, y + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void multiplySubtractAvx512(
+    double* z, const double* x, const double* y, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d difference = _mm512_fnmadd_pd(_mm512_loadu_pd(x + i),
+                                              _mm512_loadu_pd(y + i),
+                                              _mm512_loadu_pd(z + i));
+        _mm512_storeu_pd(z + i, difference);
+    }
+    multiplySubtractScalar(z + i, x + i, y + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void multiplySubtractAvx512(
+    float* z, const float* x, const float* y, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 difference = _mm512_fnmadd_ps(_mm512_loadu_ps(x + i),
+                                             _mm512_loadu_ps(y + i),
+                                             _mm512_loadu_ps(z + i));
+        _mm512_storeu_ps(z + i, difference);
+    }
+    multiplySubtractScalar(z + i, x + i, y + i, n - i);
+}
+
+#endif
+
+template <typename T>
+const SimdKernels<T>& kernelsFor(SimdLevel level) {
+    static const SimdKernels<T> scalar = {
+        axpyScalar<T>, scaleScalar<T>, dotScalar<T>, multiplyAddScalar<T>,
+        multiplySubtractScalar<T>};
+#ifdef MATRIX_X86_SIMD
+    static const SimdKernels<T> avx2 = {axpyAvx2, scaleAvx2, dotAvx2,
+                                        multiplyAddAvx2, multiplySubtractAvx2};
+    static const SimdKernels<T> avx512 = {axpyAvx512, scaleAvx512, dotAvx512,
+                                          multiplyAddAvx512,
+                                          multiplySubtractAvx512};
+    switch (std::min(level, detectSimdLevel())) {
+        case SimdLevel::AVX512:
+            return avx512;
+        case SimdLevel::AVX2:
+            return avx2;
+        case SimdLevel::SCALAR:
+            break;
+    }
+#else
+    static_cast<void>(level);
+#endif
+    return scalar;
+}
+
+}  // namespace
+
+SimdLevel detectSimdLevel() {
+#ifdef MATRIX_X86_SIMD
+    static const SimdLevel level = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return SimdLevel::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return SimdLevel::AVX2;
+        }
+        return SimdLevel::SCALAR;
+    }();
+    return level;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+SimdLevel& simdLevel() {
+    static SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+template <>
+const SimdKernels<float>& simdKernels<float>() {
+    return kernelsFor<float>(simdLevel());
+}
+
+template <>
+const SimdKernels<double>& simdKernels<double>() {
+    return kernelsFor<double>(simdLevel());
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+// Instruction sets with hand-written float/double kernels. The best one the
+// CPU supports is used unless simdLevel() is lowered, e.g. to compare
+// against the scalar code; raising it above detectSimdLevel() has no effect.
+enum class SimdLevel { SCALAR, AVX2, AVX512 };
+
+SimdLevel detectSimdLevel();
+SimdLevel& simdLevel();
+
+template <typename T>
+struct SimdKernels {
+    // y[i] += a * x[i] for i < n.
+    void (*axpy)(T* y, const T* x, T a, size_t n);
+    // y[i] *= a for i < n.
+    void (*scale)(T* y, T a, size_t n);
+    // Sum of x[i] * y[i] for i < n.
+    T (*dot)(const T* x, const T* y, size_t n);
+    // z[i] += x[i] * y[i] and z[i] -= x[i] * y[i] for i < n.
+    void (*multiplyAdd)(T* z, const T* x, const T* y, size_t n);
+    void (*multiplySubtract)(T* z, const T* x, const T* y, size_t n);
+};
+
+// Kernels for the current simdLevel(); defined for float and double.
+template <typename T>
+const SimdKernels<T>& simdKernels();
+template <>
+const SimdKernels<float>& simdKernels<float>();
+template <>
+const SimdKernels<double>& simdKernels<double>();
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <optional>
+#include <random>
+#include "matrix.h"
+
+// Minimal polynomial f (ascending coefficients, monic) of a linearly
+// recurrent sequence: sum_i f[i] * s[j + i] = 0 for every valid j.
+template <typename Field>
+std::vector<Field> berlekampMassey(const std::vector<Field>& sequence) {
+    std::vector<Field> current = {Field(1)};
+    std::vector<Field> previous = {Field(1)};
+    size_t length = 0;
+    size_t shift = 1;
+    Field previous_discrepancy(1);
+    for (size_t n = 0; n < sequence.size(); ++n) {
+        Field discrepancy = sequence[n];
+        for (size_t i = 1; i <= length; ++i) {
+            discrepancy += current[i] * sequence[n - i];
+        }
+        if (discrepancy == Field(0)) {
+            ++shift;
+            continue;
+        }
+        Field coefficient = discrepancy / previous_discrepancy;
+        std::vector<Field> saved = current;
+        if (current.size() < previous.size() + shift) {
+            current.resize(previous.size() + shift, Field(0));
+        }
+        for (size_t i = 0; i < previous.size(); ++i) {
+            current[i + shift] -= coefficient * previous[i];
+        }
+        if (2 * length <= n) {
+            length = n + 1 - length;
+            previous = std::move(saved);
+            previous_discrepancy = discrepancy;
+            shift = 1;
+        } else {
+            ++shift;
+        }
+    }
+    current.resize(length + 1, Field(0));
+    std::reverse(current.begin(), current.end());
+    return current;
+}
+
+// Compressed sparse row matrix over Z/P. Memory and every product are
+// O(nonzeros); det, rank and solve use Wiedemann's method, which only needs
+// products, so the dense n x n array is never formed. These are Monte Carlo
+// algorithms whose failure probability is about n^2 / P, so P should be a
+// large prime.
+template <size_t P>
+class SparseMatrix {
+  public:
+    using Vector = std::vector<Residue<P>>;
+    struct Entry {
+        size_t row;
+        size_t column;
+        Residue<P> value;
+    };
+    SparseMatrix(size_t rows, size_t columns, std::vector<Entry> entries);
+    size_t rows() const;
+    size_t columns() const;
+    size_t nonZeros() const;
+    Vector operator*(const Vector& x) const;
+    Vector transposedMultiply(const Vector& x) const;
+    // std::nullopt if every attempt was inconclusive, which happens with
+    // probability about (n^2 / P)^ATTEMPTS_ for nonsingular a. A zero
+    // result is always correct.
+    std::optional<Residue<P>> det() const;
+    size_t rank() const;
+    // Solution of a x = b for square nonsingular a, std::nullopt otherwise.
+    std::optional<Vector> solve(const Vector& b) const;
+
+  private:
+    static constexpr size_t ATTEMPTS_ = 3;
+    // Per thread, so const methods may run concurrently.
+    static std::mt19937_64& random();
+    static Vector randomVector(size_t size, bool nonzero);
+    template <typename Operator>
+    Vector minimalPolynomial(const Operator& apply, const Vector& start,
+                             size_t size) const;
+    size_t rows_;
+    size_t columns_;
+    std::vector<size_t> row_starts_;
+    std::vector<size_t> column_indices_;
+    Vector values_;
+};
+
+// Duplicate entries are summed and zeros dropped.
+template <size_t P>
+SparseMatrix<P>::SparseMatrix(size_t rows, size_t columns,
+                              std::vector<Entry> entries)
+    : rows_(rows), columns_(columns), row_starts_(rows + 1, 0) {
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) {
+                  return a.row != b.row ? a.row < b.row : a.column < b.column;
+              });
+    std::vector<Entry> merged;
+    for (const Entry& entry : entries) {
+        if (!merged.empty() && merged.back().row == entry.row &&
+            merged.back().column == entry.column) {
+            merged.back().value += entry.value;
+        } else {
+            merged.push_back(entry);
+        }
+    }
+    for (const Entry& entry : merged) {
+        if (entry.value == Residue<P>(0)) {
+            continue;
+        }
+        column_indices_.push_back(entry.column);
+        values_.push_back(entry.value);
+        ++row_starts_[entry.row + 1];
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        row_starts_[i + 1] += row_starts_[i];
+    }
+}
+
+template <size_t P>
+size_t SparseMatrix<P>::rows() const {
+    return rows_;
+}
+
+template <size_t P>
+size_t SparseMatrix<P>::columns() const {
+    return columns_;
+}
+
+template <size_t P>
+size_t SparseMatrix<P>::nonZeros() const {
+    return values_.size();
+}
+
+template <size_t P>
+typename SparseMatrix<P>::Vector SparseMatrix<P>::operator*(
+    const Vector& x) const {
+    Vector y(rows_);
+    for (size_t i = 0; i < rows_; ++i) {
+        typename Residue<P>::Accumulator sum;
+        for (size_t k = row_starts_[i]; k < row_starts_[i + 1]; ++k) {
+            sum.add(values_[k], x[column_indices_[k]]);
+        }
+        y[i] = sum.get();
+    }
+    return y;
+}
+
+template <size_t P>
+typename SparseMatrix<P>::Vector SparseMatrix<P>::transposedMultiply(
+    const Vector& x) const {
+    Vector y(columns_);
+    for (size_t i = 0; i < rows_; ++i) {
+        for (size_t k = row_starts_[i]; k < row_starts_[i + 1]; ++k) {
+            y[column_indices_[k]] += values_[k] * x[i];
+        }
+    }
+    return y;
+}
+
+template <size_t P>
+std::mt19937_64& SparseMatrix<P>::random() {
+    static thread_local std::mt19937_64 random;
+    return random;
+}
+
+template <size_t P>
+typename SparseMatrix<P>::Vector SparseMatrix<P>::randomVector(
+    size_t size, bool nonzero) {
+    std::uniform_int_distribution<long long> distribution(
+        nonzero ? 1 : 0, static_cast<long long>(P - 1));
+    Vector result(size);
+    for (Residue<P>& value : result) {
+        value = Residue<P>(distribution(random()));
+    }
+    return result;
+}
+
+// Minimal polynomial of the sequence u^T B^i v for random u, i < 2 size,
+// where apply computes B v; it divides the minimal polynomial of B and
+// equals it with high probability.
+template <size_t P>
+template <typename Operator>
+typename SparseMatrix<P>::Vector SparseMatrix<P>::minimalPolynomial(
+    const Operator& apply, const Vector& start, size_t size) const {
+    Vector projection = randomVector(size, false);
+    Vector sequence(2 * size);
+    Vector current = start;
+    for (size_t i = 0; i < sequence.size(); ++i) {
+        typename Residue<P>::Accumulator sum;
+        for (size_t j = 0; j < size; ++j) {
+            sum.add(projection[j], current[j]);
+        }
+        sequence[i] = sum.get();
+        if (i + 1 < sequence.size()) {
+            current = apply(current);
+        }
+    }
+    return berlekampMassey(sequence);
+}
+
+// With a random diagonal d, the minimal polynomial of a d is its
+// characteristic polynomial, whose constant term is +-det(a d). A projected
+// polynomial with a zero root proves a singular; one of degree below n
+// proves nothing, and the attempt is repeated.
+template <size_t P>
+std::optional<Residue<P>> SparseMatrix<P>::det() const {
+    static_assert(isPrime<P>, "Det: Residue is not a field");
+    assert(rows_ == columns_);
+    size_t n = rows_;
+    for (size_t attempt = 0; attempt < ATTEMPTS_; ++attempt) {
+        Vector diagonal = randomVector(n, true);
+        auto apply = [this, &diagonal](Vector x) {
+            for (size_t i = 0; i < x.size(); ++i) {
+                x[i] *= diagonal[i];
+            }
+            return *this * x;
+        };
+        Vector polynomial =
+            minimalPolynomial(apply, randomVector(n, false), n);
+        if (polynomial[0] == Residue<P>(0)) {
+            return Residue<P>(0);
+        }
+        if (polynomial.size() != n + 1) {
+            continue;
+        }
+        Residue<P> det = polynomial[0];
+        if (n % 2 == 1) {
+            det = Residue<P>(0) - det;
+        }
+        Residue<P> scale(1);
+        for (const Residue<P>& value : diagonal) {
+            scale *= value;
+        }
+        return det / scale;
+    }
+    return std::nullopt;
+}
+
+// b = d1 a^T d2 a d1 has the rank of a and, for random diagonals, a minimal
+// polynomial of degree rank(a) + [rank(a) < columns]; the projected degree
+// can only fall short, so the best of a few trials is kept.
+template <size_t P>
+size_t SparseMatrix<P>::rank() const {
+    size_t n = columns_;
+    size_t rank = 0;
+    for (size_t attempt = 0; attempt < ATTEMPTS_; ++attempt) {
+        Vector left = randomVector(n, true);
+        Vector middle = randomVector(rows_, true);
+        auto apply = [this, &left, &middle](Vector x) {
+            for (size_t i = 0; i < x.size(); ++i) {
+                x[i] *= left[i];
+            }
+            Vector y = *this * x;
+            for (size_t i = 0; i < y.size(); ++i) {
+                y[i] *= middle[i];
+            }
+            x = transposedMultiply(y);
+            for (size_t i = 0; i < x.size(); ++i) {
+                x[i] *= left[i];
+            }
+            return x;
+        };
+        Vector polynomial =
+            minimalPolynomial(apply, randomVector(n, false), n);
+        size_t degree = polynomial.size() - 1;
+        rank = std::max(rank,
+                        polynomial[0] == Residue<P>(0) ? degree - 1 : degree);
+    }
+    return rank;
+}
+
+// With f the minimal polynomial of the Krylov sequence of b and f(0) != 0,
+// x = -(f(a) - f(0)) b / (f(0) a), evaluated by Horner's rule.
+template <size_t P>
+std::optional<typename SparseMatrix<P>::Vector> SparseMatrix<P>::solve(
+    const Vector& b) const {
+    static_assert(isPrime<P>, "Solve: Residue is not a field");
+    assert(rows_ == columns_ && b.size() == rows_);
+    size_t n = rows_;
+    if (b == Vector(n)) {
+        return Vector(n);
+    }
+    auto apply = [this](const Vector& x) { return *this * x; };
+    for (size_t attempt = 0; attempt < ATTEMPTS_; ++attempt) {
+        Vector polynomial = minimalPolynomial(apply, b, n);
+        // A projection that vanishes on the whole sequence yields f = 1.
+        if (polynomial.size() == 1 || polynomial[0] == Residue<P>(0)) {
+            continue;
+        }
+        size_t degree = polynomial.size() - 1;
+        Vector x = b;
+        for (size_t i = degree - 1; i > 0; --i) {
+            x = *this * x;
+            for (size_t j = 0; j < n; ++j) {
+                x[j] += polynomial[i] * b[j];
+            }
+        }
+        Residue<P> scale = Residue<P>(0) - polynomial[0].inverse();
+        for (Residue<P>& value : x) {
+            value *= scale;
+        }
+        if (*this * x == b) {
+            return x;
+        }
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,68 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace {
+
+thread_local bool inside_worker = false;
+
+}  // namespace
+
+ThreadPool::ThreadPool(size_t threads) {
+    threads = std::max<size_t>(threads, 1);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back([this]() { work(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    condition_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::size() const {
+    return workers_.size();
+}
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool;
+    return pool;
+}
+
+bool ThreadPool::insideWorker() {
+    return inside_worker;
+}
+
+size_t& parallelThreads() {
+    static size_t threads = ThreadPool::global().size();
+    return threads;
+}
+
+size_t& parallelThreshold() {
+    static size_t threshold = 1 << 16;
+    return threshold;
+}
+
+void ThreadPool::work() {
+    inside_worker = true;
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock,
+                            [this]() { return stopped_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+        task();
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+  public:
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency());
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+    size_t size() const;
+    template <typename Function>
+    std::future<std::invoke_result_t<Function>> submit(Function function);
+    template <typename Function>
+    void parallelFor(size_t begin, size_t end, size_t chunks,
+                     const Function& function);
+    static ThreadPool& global();
+    static bool insideWorker();
+
+  private:
+    void work();
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopped_ = false;
+};
+
+template <typename Function>
+std::future<std::invoke_result_t<Function>> ThreadPool::submit(
+    Function function) {
+    using Result = std::invoke_result_t<Function>;
+    auto task =
+        std::make_shared<std::packaged_task<Result()>>(std::move(function));
+    std::future<Result> result = task->get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.emplace([task]() { (*task)(); });
+    }
+    condition_.notify_one();
+    return result;
+}
+
+// Calls function(lo, hi) on up to chunks consecutive pieces of [begin, end),
+// the first one on the calling thread. Workers run nested loops serially
+// rather than block on tasks queued behind them.
+template <typename Function>
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t chunks,
+                             const Function& function) {
+    chunks = std::min({chunks, size() + 1, end - begin});
+    if (chunks <= 1 || insideWorker()) {
+        function(begin, end);
+        return;
+    }
+    std::vector<std::future<void>> futures;
+    for (size_t i = 1; i < chunks; ++i) {
+        size_t lo = begin + (end - begin) * i / chunks;
+        size_t hi = begin + (end - begin) * (i + 1) / chunks;
+        futures.push_back(submit([lo, hi, &function]() { function(lo, hi); }));
+    }
+    function(begin, begin + (end - begin) / chunks);
+    for (std::future<void>& future : futures) {
+        future.get();
+    }
+}
+
+// Loops doing at least parallelThreshold() field operations are split
+// across parallelThreads() threads of the global pool; 1 disables it.
+size_t& parallelThreads();
+size_t& parallelThreshold();
+
+template <typename Function>
+void parallelRows(size_t begin, size_t end, size_t work,
+                  const Function& function) {
+    size_t chunks = work < parallelThreshold() ? 1 : parallelThreads();
+    ThreadPool::global().parallelFor(begin, end, chunks, function);
+}